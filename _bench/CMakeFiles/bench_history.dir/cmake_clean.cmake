@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_history.dir/bench/bench_history.cpp.o"
+  "CMakeFiles/bench_history.dir/bench/bench_history.cpp.o.d"
+  "bench_history"
+  "bench_history.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_history.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
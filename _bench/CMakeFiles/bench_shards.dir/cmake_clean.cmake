@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_shards.dir/bench/bench_shards.cpp.o"
+  "CMakeFiles/bench_shards.dir/bench/bench_shards.cpp.o.d"
+  "bench_shards"
+  "bench_shards.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_shards.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_site_actors.dir/bench/bench_site_actors.cpp.o"
+  "CMakeFiles/bench_site_actors.dir/bench/bench_site_actors.cpp.o.d"
+  "bench_site_actors"
+  "bench_site_actors.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_site_actors.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
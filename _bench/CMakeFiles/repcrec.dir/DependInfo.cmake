@@ -0,0 +1,30 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/ContentionProfiler.cpp" "CMakeFiles/repcrec.dir/src/ContentionProfiler.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/ContentionProfiler.cpp.o.d"
+  "/root/repo/src/DataManager.cpp" "CMakeFiles/repcrec.dir/src/DataManager.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/DataManager.cpp.o.d"
+  "/root/repo/src/ShardCoordinator.cpp" "CMakeFiles/repcrec.dir/src/ShardCoordinator.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/ShardCoordinator.cpp.o.d"
+  "/root/repo/src/Simulator.cpp" "CMakeFiles/repcrec.dir/src/Simulator.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/Simulator.cpp.o.d"
+  "/root/repo/src/SiteActors.cpp" "CMakeFiles/repcrec.dir/src/SiteActors.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/SiteActors.cpp.o.d"
+  "/root/repo/src/SnapshotExport.cpp" "CMakeFiles/repcrec.dir/src/SnapshotExport.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/SnapshotExport.cpp.o.d"
+  "/root/repo/src/TextPrinter.cpp" "CMakeFiles/repcrec.dir/src/TextPrinter.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/TextPrinter.cpp.o.d"
+  "/root/repo/src/Trace.cpp" "CMakeFiles/repcrec.dir/src/Trace.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/Trace.cpp.o.d"
+  "/root/repo/src/TransactionManager.cpp" "CMakeFiles/repcrec.dir/src/TransactionManager.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/TransactionManager.cpp.o.d"
+  "/root/repo/src/VersionChain.cpp" "CMakeFiles/repcrec.dir/src/VersionChain.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/VersionChain.cpp.o.d"
+  "/root/repo/src/common.cpp" "CMakeFiles/repcrec.dir/src/common.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/common.cpp.o.d"
+  "/root/repo/src/graph.cpp" "CMakeFiles/repcrec.dir/src/graph.cpp.o" "gcc" "CMakeFiles/repcrec.dir/src/graph.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
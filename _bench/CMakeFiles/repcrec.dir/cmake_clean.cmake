@@ -0,0 +1,33 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/repcrec.dir/src/ContentionProfiler.cpp.o"
+  "CMakeFiles/repcrec.dir/src/ContentionProfiler.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/DataManager.cpp.o"
+  "CMakeFiles/repcrec.dir/src/DataManager.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/ShardCoordinator.cpp.o"
+  "CMakeFiles/repcrec.dir/src/ShardCoordinator.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/Simulator.cpp.o"
+  "CMakeFiles/repcrec.dir/src/Simulator.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/SiteActors.cpp.o"
+  "CMakeFiles/repcrec.dir/src/SiteActors.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/SnapshotExport.cpp.o"
+  "CMakeFiles/repcrec.dir/src/SnapshotExport.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/TextPrinter.cpp.o"
+  "CMakeFiles/repcrec.dir/src/TextPrinter.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/Trace.cpp.o"
+  "CMakeFiles/repcrec.dir/src/Trace.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/TransactionManager.cpp.o"
+  "CMakeFiles/repcrec.dir/src/TransactionManager.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/VersionChain.cpp.o"
+  "CMakeFiles/repcrec.dir/src/VersionChain.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/common.cpp.o"
+  "CMakeFiles/repcrec.dir/src/common.cpp.o.d"
+  "CMakeFiles/repcrec.dir/src/graph.cpp.o"
+  "CMakeFiles/repcrec.dir/src/graph.cpp.o.d"
+  "librepcrec.a"
+  "librepcrec.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/repcrec.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,120 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Commit throughput with batched validation. A synthetic
+ *                workload (waves of concurrent transactions with reads and
+ *                writes, each wave closed by a burst of ends in shuffled
+ *                order) is replayed with commit batches of 1, 4, 16, 64 and
+ *                256 ends. Every run must report the same reads and commit
+ *                outcomes as the unbatched one.
+ *
+ * Inputs:        Optional argv[1]: number of transactions (default 4000)
+ *                Optional argv[2]: transactions per wave (default 128)
+ *                Optional argv[3]: operations per transaction (default 2)
+ *
+ * Outputs:       Ends per second for each batch size, and the outcome digest
+ ****************************************************************************/
+
+#include <chrono>
+#include <random>
+#include "TransactionManager.h"
+
+// FNV-1a over the reads and commit outcomes, in the order they are reported
+class DigestSink : public ResultSink {
+public:
+    uint64_t digest = 14695981039346656037ull;
+    size_t commits = 0;
+
+    void onRead(const ReadResult& r) override {
+        mix(r.tranID);
+        mix(r.var);
+        mix(r.value);
+        mix(static_cast<int>(r.status));
+    }
+    void onCommit(const CommitResult& r) override {
+        mix(r.tranID);
+        mix(r.committed);
+        mix(static_cast<int>(r.reason));
+        commits += r.committed;
+    }
+
+private:
+    void mix(long long v) {
+        digest = (digest ^ static_cast<uint64_t>(v)) * 1099511628211ull;
+    }
+};
+
+static vector<Command> makeWorkload(int tranNum, int wave, int ops) {
+    mt19937 rng(23);
+    uniform_int_distribution<var_id> anyVar(1, VAR_NUM);
+    vector<Command> cmds;
+    auto add = [&cmds](CommandType type, tran_id id, var_id var = 0, int value = 0) {
+        Command cmd;
+        cmd.type = type;
+        cmd.id = id;
+        cmd.var = var;
+        cmd.value = value;
+        cmds.push_back(cmd);
+    };
+
+    for (int base = 1; base <= tranNum; base += wave) {
+        vector<tran_id> ids;
+        for (tran_id t = base; t <= min(tranNum, base + wave - 1); ++t) {
+            ids.push_back(t);
+            add(CommandType::Begin, t);
+        }
+        for (int k = 0; k < ops; ++k) {
+            for (tran_id t : ids) {
+                if (k % 2 == 0)
+                    add(CommandType::Read, t, anyVar(rng));
+                else
+                    add(CommandType::Write, t, anyVar(rng), t * 10 + k);
+            }
+        }
+        shuffle(ids.begin(), ids.end(), rng);
+        for (tran_id t : ids)
+            add(CommandType::End, t);
+    }
+    return cmds;
+}
+
+int main(int argc, char** argv) {
+    int tranNum = argc > 1 ? stoi(argv[1]) : 4000;
+    int wave = argc > 2 ? stoi(argv[2]) : 128;
+    int ops = argc > 3 ? stoi(argv[3]) : 2;
+
+    vector<Command> cmds = makeWorkload(tranNum, wave, ops);
+    cout << "commands: " << cmds.size() << ", ends: " << tranNum << endl;
+
+    uint64_t expected = 0;
+    double unbatched = 0.0;
+    bool same = true;
+    for (size_t batch : { 1, 4, 16, 64, 256 }) {
+        DigestSink sink;
+        double seconds;
+        {
+            TransactionManager manager;
+            manager.setSink(&sink);
+            manager.setCommitBatch(batch);
+            auto t0 = chrono::steady_clock::now();
+            globalTime = 0.0;
+            for (const Command& cmd : cmds) {
+                manager.execute(cmd);
+                globalTime += 0.1;
+            }
+            manager.flush();
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        }
+        if (batch == 1) {
+            expected = sink.digest;
+            unbatched = seconds;
+        }
+        same &= sink.digest == expected;
+        cout << "batch " << batch << ":\t" << tranNum / seconds << " ends/s, "
+            << sink.commits << " committed (" << unbatched / seconds << "x)"
+            << (sink.digest == expected ? "" : "  MISMATCH") << endl;
+    }
+    cout << "digest:   " << hex << expected << dec << (same ? " (all batch sizes agree)" : " (batch sizes differ)") << endl;
+    return same ? 0 : 1;
+}
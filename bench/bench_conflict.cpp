@@ -0,0 +1,95 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Micro-benchmark for commit-time conflict checks. It compares
+ *                the hash-set probes previously used by TransactionManager
+ *                (probe every variable of one transaction against the
+ *                read/write set of every other) with the bitset signatures
+ *                (one AND over the var_set words per pair).
+ *
+ * Inputs:        Optional argv[1]: number of transactions (default 200)
+ *                Optional argv[2]: variables touched per transaction (default 5)
+ *
+ * Outputs:       Timing of both methods, printed to stdout
+ ****************************************************************************/
+
+#include <chrono>
+#include <random>
+#include "common.h"
+
+struct SetTran {
+    unordered_set<var_id> read;
+    unordered_set<var_id> write;
+};
+
+struct MaskTran {
+    var_set readMask;
+    var_set writeMask;
+};
+
+int main(int argc, char** argv) {
+    int tranNum = argc > 1 ? stoi(argv[1]) : 200;
+    int opNum = argc > 2 ? stoi(argv[2]) : 5;
+    const int rounds = 50;
+
+    mt19937 rng(42);
+    uniform_int_distribution<var_id> pick(1, VAR_NUM);
+    vector<SetTran> sets(tranNum);
+    vector<MaskTran> masks(tranNum);
+    for (int i = 0; i < tranNum; ++i) {
+        for (int j = 0; j < opNum; ++j) {
+            var_id r = pick(rng), w = pick(rng);
+            sets[i].read.insert(r);
+            sets[i].write.insert(w);
+            masks[i].readMask.set(r);
+            masks[i].writeMask.set(w);
+        }
+    }
+
+    using clock = chrono::steady_clock;
+    long long hits = 0;
+
+    auto t0 = clock::now();
+    for (int k = 0; k < rounds; ++k) {
+        for (int i = 0; i < tranNum; ++i) {
+            for (int j = 0; j < tranNum; ++j) {
+                if (i == j)
+                    continue;
+                bool overlap = false;
+                for (var_id v : sets[i].write) {
+                    if (sets[j].write.count(v) || sets[j].read.count(v)) {
+                        overlap = true;
+                        break;
+                    }
+                }
+                hits += overlap;
+            }
+        }
+    }
+    auto t1 = clock::now();
+    for (int k = 0; k < rounds; ++k) {
+        for (int i = 0; i < tranNum; ++i) {
+            for (int j = 0; j < tranNum; ++j) {
+                if (i == j)
+                    continue;
+                hits -= ((masks[i].writeMask & (masks[j].writeMask | masks[j].readMask)).any());
+            }
+        }
+    }
+    auto t2 = clock::now();
+
+    double setMs = chrono::duration<double, milli>(t1 - t0).count();
+    double maskMs = chrono::duration<double, milli>(t2 - t1).count();
+    long long pairs = 1LL * rounds * tranNum * (tranNum - 1);
+    cout << "pairs checked:  " << pairs << endl;
+    cout << "hash-set probe: " << setMs << " ms" << endl;
+    cout << "bitset AND:     " << maskMs << " ms" << endl;
+    cout << "speedup:        " << (maskMs > 0 ? setMs / maskMs : 0) << "x" << endl;
+    // both methods must agree on every pair
+    if (hits != 0) {
+        cout << "Mismatch between methods!" << endl;
+        return 1;
+    }
+    return 0;
+}
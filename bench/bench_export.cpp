@@ -0,0 +1,129 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Snapshot export throughput. Sites with a deep version
+ *                history are exported at a time in the middle of it:
+ *                 - print-and-sort on the calling thread, as dump(t) does,
+ *                 - SnapshotExport in text with one and several workers,
+ *                 - SnapshotExport in binary,
+ *                 - a text export while the calling thread keeps committing
+ *                   newer versions, which must not change the snapshot.
+ *                Every export is checked against the print-and-sort output.
+ *
+ * Inputs:        Optional argv[1]: number of sites (default 400)
+ *                Optional argv[2]: versions per variable (default 64)
+ *                Optional argv[3]: export workers (default 4)
+ *
+ * Outputs:       Values per second, size and how long the calling thread is
+ *                held for each way, commits per second with and without an
+ *                export running
+ ****************************************************************************/
+
+#include <memory>
+#include <sstream>
+#include "DataManager.h"
+#include "SnapshotExport.h"
+#include "TextPrinter.h"
+
+static double seconds(chrono::steady_clock::time_point since) {
+    return chrono::duration<double>(chrono::steady_clock::now() - since).count();
+}
+
+int main(int argc, char** argv) {
+    size_t siteNum = argc > 1 ? stoul(argv[1]) : 400;
+    int versions = argc > 2 ? stoi(argv[2]) : 64;
+    size_t threads = argc > 3 ? stoul(argv[3]) : 4;
+
+    vector<unique_ptr<DataManager>> owned;
+    vector<DataManager*> sites;
+    for (site_id s = 1; s <= static_cast<site_id>(siteNum); ++s) {
+        owned.push_back(make_unique<DataManager>(s));
+        sites.push_back(owned.back().get());
+    }
+    for (int v = 1; v <= versions; ++v) {
+        for (DataManager* site : sites) {
+            for (auto& [id, var] : site->getVariables())
+                site->applyReplicated(id, id * 1000 + v, v);
+        }
+    }
+    double time = versions / 2 + 0.5;
+
+    /**   print-and-sort, as dump(t)   **/
+    auto t0 = chrono::steady_clock::now();
+    vector<SiteSnapshot> snapshot;
+    size_t values = 0;
+    for (DataManager* site : sites) {
+        SiteSnapshot current = { site->getSiteID(), {} };
+        for (const auto& [id, var] : site->getVariables()) {
+            auto [commitTime, value] = site->readAt(id, time);
+            if (commitTime >= 0)
+                current.values.emplace_back(id, value);
+        }
+        sort(current.values.begin(), current.values.end());
+        values += current.values.size();
+        snapshot.push_back(move(current));
+    }
+    ostringstream expected;
+    TextPrinter(expected).onDump(snapshot);
+    double serial = seconds(t0);
+    cout << "sites: " << siteNum << ", values: " << values << ", versions per variable: " << versions << endl;
+    cout << "print-and-sort:        " << values / serial << " values/s, " << expected.str().size()
+        << " bytes, caller held " << serial * 1e6 << " us" << endl;
+
+    bool ok = true;
+    auto run = [&](const string& name, ExportFormat format, size_t workers) {
+        ostringstream out;
+        auto start = chrono::steady_clock::now();
+        SnapshotExport job(sites, time, out, format, workers);
+        double held = seconds(start);       // the caller is free once the workers are started
+        SnapshotExport::Stats stats = job.wait();
+        bool same;
+        if (format == ExportFormat::text)
+            same = out.str() == expected.str();
+        else {
+            istringstream in(out.str());
+            double readTime;
+            vector<SiteSnapshot> decoded;
+            same = SnapshotExport::read(in, readTime, decoded) && readTime == time && decoded.size() == snapshot.size();
+            for (size_t i = 0; same && i < decoded.size(); ++i)
+                same = decoded[i].site == snapshot[i].site && decoded[i].values == snapshot[i].values;
+        }
+        ok &= same;
+        cout << name << values / stats.seconds << " values/s, " << stats.bytes << " bytes ("
+            << serial / stats.seconds << "x), caller held " << held * 1e6 << " us"
+            << (same ? "" : "  MISMATCH") << endl;
+    };
+    run("export text, 1 worker: ", ExportFormat::text, 1);
+    run("export text, " + to_string(threads) + " workers:", ExportFormat::text, threads);
+    run("export binary, " + to_string(threads) + " wkr: ", ExportFormat::binary, threads);
+
+    /**   commits while an export runs   **/
+    auto commit = [&](size_t k) {
+        DataManager* site = sites[k % sites.size()];
+        var_id id = 2 + 2 * static_cast<var_id>(k / sites.size() % (VAR_NUM / 2));
+        site->applyReplicated(id, -1, versions + 1.0 + k);
+    };
+    const size_t rounds = 1 << 18;
+    size_t commits = 0;
+    t0 = chrono::steady_clock::now();
+    for (size_t k = 0; k < rounds; ++k)
+        commit(commits++);
+    double alone = rounds / seconds(t0);
+
+    ostringstream out;
+    t0 = chrono::steady_clock::now();
+    double busy;
+    {
+        SnapshotExport job(sites, time, out, ExportFormat::text, threads);
+        for (size_t k = 0; k < rounds; ++k)
+            commit(commits++);
+        busy = rounds / seconds(t0);
+        job.wait();
+    }
+    bool unchanged = out.str() == expected.str();
+    ok &= unchanged;
+    cout << "commits: " << alone << "/s alone, " << busy << "/s during an export, snapshot "
+        << (unchanged ? "unchanged" : "CHANGED") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Throughput benchmark for non-transactional time-travel
+ *                reads. It commits a number of single-write transactions to
+ *                build a version history, then runs bulk readAt() lookups
+ *                at random past times and a series of dumpAt() scans.
+ *
+ * Inputs:        Optional argv[1]: number of committed versions (default 20000)
+ *                Optional argv[2]: number of readAt lookups (default 1000000)
+ *
+ * Outputs:       Lookups per second and dumps per second
+ ****************************************************************************/
+
+#include <chrono>
+#include <random>
+#include "TransactionManager.h"
+
+int main(int argc, char** argv) {
+    int versions = argc > 1 ? stoi(argv[1]) : 20000;
+    int lookups = argc > 2 ? stoi(argv[2]) : 1000000;
+
+    TransactionManager manager;     // no sink, results are only returned
+    mt19937 rng(3);
+    uniform_int_distribution<var_id> anyVar(1, VAR_NUM);
+
+    globalTime = 0.0;
+    for (tran_id t = 1; t <= versions; ++t) {
+        manager.beginTransaction(t);
+        manager.writeTransaction(t, anyVar(rng), t);
+        manager.endTransaction(t);
+        globalTime += 1.0;
+    }
+    uniform_real_distribution<double> anyTime(0.0, globalTime);
+
+    auto t0 = chrono::steady_clock::now();
+    long long checksum = 0;
+    for (int i = 0; i < lookups; ++i) {
+        HistoryRead r = manager.readAt(anyVar(rng), anyTime(rng));
+        checksum += r.found ? r.value : 0;
+    }
+    auto t1 = chrono::steady_clock::now();
+    const int dumps = 1000;
+    for (int i = 0; i < dumps; ++i)
+        checksum += manager.dumpAt(anyTime(rng)).size();
+    auto t2 = chrono::steady_clock::now();
+
+    double readSec = chrono::duration<double>(t1 - t0).count();
+    double dumpSec = chrono::duration<double>(t2 - t1).count();
+    cout << "versions:  " << versions << endl;
+    cout << "readAt:    " << lookups / readSec << " lookups/s" << endl;
+    cout << "dump(t):   " << dumps / dumpSec << " dumps/s ("
+        << dumps * SITE_NUM / dumpSec << " site scans/s)" << endl;
+    cout << "checksum:  " << checksum << endl;
+    return 0;
+}
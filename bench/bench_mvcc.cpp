@@ -0,0 +1,139 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Multi-threaded benchmark for snapshot reads running while
+ *                commits go on. One writer thread commits to a DataManager
+ *                and prunes versions older than a window; reader threads run
+ *                DataManager::read() at random snapshots inside the window.
+ *                The same workload is run on a std::map history guarded by
+ *                a shared_mutex, the locked alternative to VersionChain.
+ *
+ * Inputs:        Optional argv[1]: max reader threads (default 8)
+ *                Optional argv[2]: milliseconds per run (default 500)
+ *
+ * Outputs:       Reader and writer throughput per reader count
+ ****************************************************************************/
+
+#include <chrono>
+#include <random>
+#include <thread>
+#include <shared_mutex>
+#include "DataManager.h"
+
+const double window = 1000.0;       // versions kept behind the newest commit
+const int pruneEvery = 1000;
+
+// the locked alternative: one map per variable, readers share the lock
+struct LockedSite {
+    mutable shared_mutex lock;
+    unordered_map<var_id, map<double, int>> history;
+
+    void commit(var_id var, double time, int value) {
+        unique_lock<shared_mutex> lk(lock);
+        history[var][time] = value;
+    }
+    void prune(double before) {
+        unique_lock<shared_mutex> lk(lock);
+        for (auto& [id, versions] : history) {
+            auto keep = versions.upper_bound(before);
+            if (keep != versions.begin())
+                versions.erase(versions.begin(), prev(keep));
+        }
+    }
+    pair<bool, int> read(var_id var, double time) const {
+        shared_lock<shared_mutex> lk(lock);
+        const auto& versions = history.at(var);
+        auto it = versions.upper_bound(time);
+        if (it == versions.begin())
+            return { false, -1 };
+        return { true, prev(it)->second };
+    }
+};
+
+struct Run {
+    double reads;       // per second, all readers
+    double commits;     // per second
+    long long checksum;
+};
+
+// writer: commit(var, time, value) and prune(before); reader: read(var, time)
+template <typename Commit, typename Prune, typename Read>
+Run measure(int readers, int millis, Commit commit, Prune prune, Read read) {
+    const vector<var_id> vars = { 1, 2, 4, 6, 8, 11 };     // all held by site 2
+    atomic<bool> stop{ false };
+    atomic<double> now{ 0.0 };
+    atomic<long long> reads{ 0 };
+    atomic<long long> checksum{ 0 };
+    long long commits = 0;
+
+    thread writer([&] {
+        mt19937 rng(1);
+        double time = 0.0;
+        while (!stop.load(memory_order_relaxed)) {
+            time += 1.0;
+            commit(vars[rng() % vars.size()], time, static_cast<int>(commits));
+            now.store(time, memory_order_release);
+            if (++commits % pruneEvery == 0)
+                prune(time - window);
+        }
+    });
+
+    vector<thread> pool;
+    for (int r = 0; r < readers; ++r) {
+        pool.emplace_back([&, r] {
+            mt19937 rng(100 + r);
+            uniform_real_distribution<double> back(0.0, window);
+            long long n = 0, sum = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                double time = max(0.0, now.load(memory_order_acquire) - back(rng));
+                sum += read(vars[rng() % vars.size()], time).second;
+                ++n;
+            }
+            reads += n;
+            checksum += sum;
+        });
+    }
+
+    this_thread::sleep_for(chrono::milliseconds(millis));
+    stop = true;
+    writer.join();
+    for (thread& t : pool)
+        t.join();
+    double sec = millis / 1000.0;
+    return { reads / sec, commits / sec, checksum };
+}
+
+int main(int argc, char** argv) {
+    int maxReaders = argc > 1 ? stoi(argv[1]) : 8;
+    int millis = argc > 2 ? stoi(argv[2]) : 500;
+
+    cout << "readers | chain reads/s  commits/s | locked map reads/s  commits/s" << endl;
+    for (int readers = 1; readers <= maxReaders; readers *= 2) {
+        DataManager site(2);
+        tran_id tranID = 0;
+        Run chain = measure(readers, millis,
+            [&](var_id var, double time, int value) {
+                globalTime = time;      // the writer's clock stamps the commit
+                site.write(++tranID, var, value);
+                site.commitWrite(tranID, var, value);
+            },
+            [&](double before) { site.pruneVersions(before); },
+            [&](var_id var, double time) { return site.read(var, time); });
+
+        LockedSite locked;
+        for (var_id var : { 1, 2, 4, 6, 8, 11 })
+            locked.commit(var, 0.0, var * 10);
+        Run baseline = measure(readers, millis,
+            [&](var_id var, double time, int value) { locked.commit(var, time, value); },
+            [&](double before) { locked.prune(before); },
+            [&](var_id var, double time) { return locked.read(var, time); });
+
+        cout << readers << "       | " << chain.reads << "  " << chain.commits
+            << " | " << baseline.reads << "  " << baseline.commits
+            << "   (checksum " << (chain.checksum ^ baseline.checksum) << ")" << endl;
+    }
+    Epoch::reclaim();
+    cout << "versions waiting for reclamation: " << Epoch::pending() << endl;
+    return 0;
+}
@@ -0,0 +1,447 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Replay harness. Runs traces (text or binary) through a
+ *                TransactionManager as fast as it can and checks them:
+ *                 - Serial oracle: the committed transactions are ordered by
+ *                   their dependencies (who read whose version, who
+ *                   overwrote what) and re-run one at a time on a plain
+ *                   map; every read must return the value the engine
+ *                   returned, every readAt must match the commit history,
+ *                   and the final store must match the newest value held by
+ *                   the sites. A cycle means the history is not serializable.
+ *                   Under SSI this order can differ from commit order (a
+ *                   reader that overlapped a later committer goes first), so
+ *                   replaying in plain commit order would give false alarms.
+ *                   The engine reads from the snapshot only, never its own
+ *                   writes, so a transaction's reads run before its writes.
+ *                 - Determinism: every run must print the same output.
+ *                 - Timing: wall clock of the best run and its mean time
+ *                   per command type, compared with a stored baseline; a
+ *                   different output, or a slowdown beyond both the relative
+ *                   tolerance and an absolute floor, is reported as a
+ *                   regression.
+ *
+ * Inputs:        bench_replay [--runs N] [--baseline FILE] [--save FILE]
+ *                             [--tolerance F] [--floor US] <trace>...
+ *                Baseline lines: <trace> <wall_us> <digest> <type>=<ns>...
+ *
+ * Outputs:       A report per trace; exit status 1 on any failure
+ ****************************************************************************/
+
+#include <chrono>
+#include <queue>
+#include <sstream>
+#include "TransactionManager.h"
+#include "TextPrinter.h"
+#include "Trace.h"
+
+struct Step {
+    Command cmd;
+    double time;
+};
+
+static const int typeNum = static_cast<int>(CommandType::Contention) + 1;
+static const char* typeNames[typeNum] = {
+    "none", "begin", "R", "W", "end", "fail", "recover", "dump", "queryState",
+    "replication", "lag", "readAt", "RB", "WB", "admission", "admissionStats", "contention"
+};
+
+static bool loadTrace(const string& path, vector<Step>& steps) {
+    ifstream in(path, ios::binary);
+    if (!in.is_open())
+        return false;
+    if (TraceReader::isBinary(in)) {
+        TraceReader reader(in);
+        Step step;
+        while (reader.next(step.cmd, step.time))
+            steps.push_back(step);
+        return true;
+    }
+    string line;
+    double time = 0.0;
+    while (getline(in, line)) {
+        Command cmd = parseCommand(line);
+        if (cmd.type != CommandType::None)
+            steps.push_back({ cmd, time });
+        time += 0.1;
+    }
+    return true;
+}
+
+// prints like main, and keeps what the oracle needs
+class Recorder : public ResultSink {
+public:
+    struct Tran {
+        tran_id id = 0;
+        double startTime = -1.0;
+        double commitTime = -1.0;
+        vector<pair<var_id, int>> reads;
+        map<var_id, int> writes;
+    };
+
+    vector<Tran> committed;         // in commit order
+    vector<HistoryRead> histories;
+    size_t aborted = 0;
+
+    Recorder(const TransactionManager& manager, ostream& out) : manager(manager), printer(out) {}
+
+    void onRead(const ReadResult& r) override {
+        printer.onRead(r);
+        if (r.status != ReadStatus::ok)
+            return;
+        Tran& t = live[r.tranID];
+        if (t.startTime < 0)
+            t.startTime = manager.getStartTime(r.tranID);
+        t.reads.emplace_back(r.var, r.value);
+    }
+    void onWrite(const WriteResult& r) override { printer.onWrite(r); }
+    void onCommit(const CommitResult& r) override {
+        printer.onCommit(r);
+        Tran t = live[r.tranID];
+        live.erase(r.tranID);
+        if (!r.committed) {
+            ++aborted;
+            return;
+        }
+        t.id = r.tranID;
+        t.commitTime = currentTime();
+        for (const SiteWrite& w : r.writes)
+            t.writes[w.var] = w.value;
+        committed.push_back(move(t));
+    }
+    void onHistory(const HistoryRead& r) override {
+        printer.onHistory(r);
+        histories.push_back(r);
+    }
+    void onDump(const vector<SiteSnapshot>& r) override { printer.onDump(r); }
+    void onLag(const vector<ReplicaStats>& r) override { printer.onLag(r); }
+    void onAdmission(const AdmissionStats& r) override { printer.onAdmission(r); }
+    void onContention(const vector<HotVariable>& r) override { printer.onContention(r); }
+    void onMessage(const string& r) override { printer.onMessage(r); }
+
+private:
+    const TransactionManager& manager;
+    TextPrinter printer;
+    unordered_map<tran_id, Tran> live;
+};
+
+// re-run the committed transactions serially, returns the problems found
+static vector<string> checkOracle(const Recorder& rec, const TransactionManager& manager) {
+    vector<string> errors;
+    const vector<Recorder::Tran>& trans = rec.committed;
+    size_t n = trans.size();
+
+    /**   serialization graph of the committed history   **/
+    vector<vector<size_t>> writers(VAR_NUM + 1);     // in commit order
+    for (size_t i = 0; i < n; ++i) {
+        for (const auto& [varID, value] : trans[i].writes)
+            writers[varID].push_back(i);
+    }
+    struct Edge {
+        size_t to;
+        const char* type;
+        var_id var;
+    };
+    vector<vector<Edge>> next(n);
+    vector<int> indegree(n, 0);
+    auto edge = [&](size_t from, size_t to, const char* type, var_id varID) {
+        if (from == to)
+            return;
+        next[from].push_back({ to, type, varID });
+        ++indegree[to];
+    };
+    for (var_id x = 1; x <= VAR_NUM; ++x) {
+        for (size_t k = 1; k < writers[x].size(); ++k)
+            edge(writers[x][k - 1], writers[x][k], "ww", x);
+    }
+    for (size_t j = 0; j < n; ++j) {
+        for (const auto& [varID, value] : trans[j].reads) {
+            const vector<size_t>& w = writers[varID];
+            auto after = partition_point(w.begin(), w.end(), [&](size_t i) {
+                return trans[i].commitTime <= trans[j].startTime;
+            });
+            if (after != w.begin())
+                edge(*prev(after), j, "wr", varID);     // j read the last version before its start
+            for (; after != w.end(); ++after) {
+                if (*after != j) {
+                    edge(j, *after, "rw", varID);      // the next writer overwrote what j read
+                    break;
+                }
+            }
+        }
+    }
+
+    /**   serial order, ties broken by commit order   **/
+    priority_queue<size_t, vector<size_t>, greater<size_t>> ready;
+    for (size_t i = 0; i < n; ++i) {
+        if (indegree[i] == 0)
+            ready.push(i);
+    }
+    vector<size_t> order;
+    while (!ready.empty()) {
+        size_t i = ready.top();
+        ready.pop();
+        order.push_back(i);
+        for (const Edge& e : next[i]) {
+            if (--indegree[e.to] == 0)
+                ready.push(e.to);
+        }
+    }
+    if (order.size() < n) {
+        // every transaction left over has a left over predecessor: walk back until one repeats
+        vector<pair<size_t, const Edge*>> pred(n, { n, nullptr });
+        for (size_t u = 0; u < n; ++u) {
+            for (const Edge& e : next[u]) {
+                if (indegree[u] > 0 && indegree[e.to] > 0)
+                    pred[e.to] = { u, &e };
+            }
+        }
+        size_t cur = 0;
+        while (indegree[cur] == 0)
+            ++cur;
+        vector<bool> seen(n, false);
+        while (!seen[cur]) {
+            seen[cur] = true;
+            cur = pred[cur].first;
+        }
+        string cycle = "not serializable: T" + to_string(trans[cur].id);
+        vector<string> steps;
+        for (size_t v = cur; steps.empty() || v != cur; v = pred[v].first) {
+            const Edge* e = pred[v].second;
+            steps.push_back(" -" + string(e->type) + "(x" + to_string(e->var) + ")-> T" + to_string(trans[v].id));
+        }
+        for (auto it = steps.rbegin(); it != steps.rend(); ++it)
+            cycle += *it;
+        errors.push_back(cycle);
+        return errors;
+    }
+
+    /**   serial replay   **/
+    vector<int> store(VAR_NUM + 1);
+    for (var_id x = 1; x <= VAR_NUM; ++x)
+        store[x] = 10 * x;
+    for (size_t i : order) {
+        for (const auto& [varID, value] : trans[i].reads) {
+            if (store[varID] != value) {
+                errors.push_back("T" + to_string(trans[i].id) + " read x" + to_string(varID) + " = " + to_string(value)
+                    + ", serial order gives " + to_string(store[varID]));
+            }
+        }
+        for (const auto& [varID, value] : trans[i].writes)
+            store[varID] = value;
+    }
+
+    /**   readAt against the commit history   **/
+    for (const HistoryRead& r : rec.histories) {
+        if (!r.found)
+            continue;
+        int expected = 10 * r.var;
+        for (size_t i : writers[r.var]) {
+            if (trans[i].commitTime <= r.time)
+                expected = trans[i].writes.at(r.var);
+        }
+        if (r.value != expected) {
+            errors.push_back("readAt(x" + to_string(r.var) + ", " + to_string(r.time) + ") = " + to_string(r.value)
+                + ", history gives " + to_string(expected));
+        }
+    }
+
+    /**   final state: newest value of every variable across sites   **/
+    for (var_id x = 1; x <= VAR_NUM; ++x) {
+        double newest = -1.0;
+        int value = 0;
+        for (site_id s = 1; s <= SITE_NUM; ++s) {
+            auto& vars = manager.getSite(s)->getVariables();
+            auto it = vars.find(x);
+            if (it != vars.end() && it->second.lastCommitTime > newest) {
+                newest = it->second.lastCommitTime;
+                value = it->second.value;
+            }
+        }
+        if (value != store[x]) {
+            errors.push_back("final x" + to_string(x) + " = " + to_string(value)
+                + ", serial order gives " + to_string(store[x]));
+        }
+    }
+    return errors;
+}
+
+static uint64_t digest(const string& text) {
+    uint64_t h = 1469598103934665603ull;     // FNV-1a
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+struct Baseline {
+    double wallUs = 0.0;
+    uint64_t digest = 0;
+    map<string, double> perType;    // mean ns per command
+};
+
+static map<string, Baseline> loadBaselines(const string& path) {
+    map<string, Baseline> baselines;
+    ifstream in(path);
+    string line;
+    while (getline(in, line)) {
+        istringstream fields(line);
+        string name, entry;
+        Baseline b;
+        if (!(fields >> name >> b.wallUs >> hex >> b.digest >> dec))
+            continue;
+        while (fields >> entry) {
+            size_t eq = entry.find('=');
+            if (eq != string::npos)
+                b.perType[entry.substr(0, eq)] = stod(entry.substr(eq + 1));
+        }
+        baselines[name] = b;
+    }
+    return baselines;
+}
+
+static void saveBaselines(const string& path, const map<string, Baseline>& baselines) {
+    ofstream out(path);
+    for (const auto& [name, b] : baselines) {
+        out << name << " " << b.wallUs << " " << hex << b.digest << dec;
+        for (const auto& [type, ns] : b.perType)
+            out << " " << type << "=" << ns;
+        out << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    int runs = 20;
+    double tolerance = 0.25;
+    double floorUs = 5.0;       // smaller slowdowns are timer noise on short traces
+    string baselinePath, savePath;
+    vector<string> traces;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc)
+            runs = max(1, stoi(argv[++i]));
+        else if (arg == "--baseline" && i + 1 < argc)
+            baselinePath = argv[++i];
+        else if (arg == "--save" && i + 1 < argc)
+            savePath = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc)
+            tolerance = stod(argv[++i]);
+        else if (arg == "--floor" && i + 1 < argc)
+            floorUs = stod(argv[++i]);
+        else
+            traces.push_back(arg);
+    }
+    if (traces.empty()) {
+        cout << "usage: bench_replay [--runs N] [--baseline FILE] [--save FILE] [--tolerance F] [--floor US] <trace>..." << endl;
+        return 1;
+    }
+
+    map<string, Baseline> baselines;
+    if (!baselinePath.empty())
+        baselines = loadBaselines(baselinePath);
+    map<string, Baseline> measured = savePath.empty() ? map<string, Baseline>() : loadBaselines(savePath);
+    bool failed = false;
+
+    for (const string& path : traces) {
+        string name = path.substr(path.find_last_of('/') + 1);
+        vector<Step> steps;
+        if (!loadTrace(path, steps)) {
+            cout << name << ": cannot open" << endl;
+            failed = true;
+            continue;
+        }
+
+        vector<string> problems;
+        double best = numeric_limits<double>::infinity();
+        vector<double> typeNs(typeNum, 0.0), bestTypeNs;       // per command type, best run kept
+        vector<size_t> typeCount(typeNum, 0);
+        uint64_t firstDigest = 0;
+        size_t committed = 0, aborted = 0;
+
+        for (int run = 0; run < runs; ++run) {
+            ostringstream out;
+            TransactionManager manager;
+            Recorder recorder(manager, out);
+            manager.setSink(&recorder);
+
+            fill(typeNs.begin(), typeNs.end(), 0.0);
+            fill(typeCount.begin(), typeCount.end(), 0);
+            auto start = chrono::steady_clock::now();
+            for (const Step& step : steps) {
+                globalTime = step.time;
+                auto t0 = chrono::steady_clock::now();
+                manager.execute(step.cmd);
+                auto t1 = chrono::steady_clock::now();
+                int type = static_cast<int>(step.cmd.type);
+                typeNs[type] += chrono::duration<double, nano>(t1 - t0).count();
+                ++typeCount[type];
+            }
+            double wall = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+            if (wall < best) {
+                best = wall;
+                bestTypeNs = typeNs;
+            }
+
+            uint64_t d = digest(out.str());
+            if (run == 0) {
+                firstDigest = d;
+                committed = recorder.committed.size();
+                aborted = recorder.aborted;
+                problems = checkOracle(recorder, manager);
+            }
+            else if (d != firstDigest && problems.empty())
+                problems.push_back("run " + to_string(run) + " printed a different output");
+        }
+
+        Baseline current = { best, firstDigest, {} };
+        map<string, size_t> currentCount;
+        for (int type = 0; type < typeNum; ++type) {
+            if (typeCount[type] > 0) {
+                current.perType[typeNames[type]] = bestTypeNs[type] / typeCount[type];
+                currentCount[typeNames[type]] = typeCount[type];
+            }
+        }
+
+        cout << name << ": " << steps.size() << " commands, " << committed << " committed, " << aborted << " aborted" << endl;
+        if (problems.empty())
+            cout << "  oracle: ok" << endl;
+        for (const string& p : problems)
+            cout << "  FAIL: " << p << endl;
+        cout << "  wall: " << best << " us, best of " << runs << endl;
+        cout << "  per command:";
+        for (const auto& [type, ns] : current.perType)
+            cout << " " << type << " " << ns << " ns";
+        cout << endl;
+        failed |= !problems.empty();
+
+        auto base = baselines.find(name);
+        if (base != baselines.end()) {
+            vector<string> regressions;
+            if (base->second.digest != current.digest)
+                regressions.push_back("output differs from the baseline");
+            auto slower = [&](double now, double before, size_t count) {
+                return now > before * (1 + tolerance) && (now - before) * count > floorUs;
+            };
+            if (slower(current.wallUs, base->second.wallUs, 1))
+                regressions.push_back("wall " + to_string(current.wallUs) + " us vs " + to_string(base->second.wallUs));
+            for (const auto& [type, ns] : current.perType) {
+                auto old = base->second.perType.find(type);
+                if (old != base->second.perType.end() && slower(ns / 1000, old->second / 1000, currentCount.at(type)))
+                    regressions.push_back(type + " " + to_string(ns) + " ns vs " + to_string(old->second));
+            }
+            if (regressions.empty())
+                cout << "  baseline: ok" << endl;
+            for (const string& r : regressions)
+                cout << "  REGRESSION: " << r << endl;
+            failed |= !regressions.empty();
+        }
+        measured[name] = current;
+    }
+
+    if (!savePath.empty())
+        saveBaselines(savePath, measured);
+    return failed ? 1 : 0;
+}
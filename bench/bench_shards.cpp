@@ -0,0 +1,78 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Throughput benchmark for the partitioned mode. A synthetic
+ *                workload runs in waves of concurrent transactions; each
+ *                transaction has a home shard and picks its variables from
+ *                it with the given probability, otherwise from anywhere.
+ *                The same workload is run with 1, 2, 4 and 8 shards.
+ *
+ * Inputs:        Optional argv[1]: number of transactions (default 2000)
+ *                Optional argv[2]: local probability in [0, 1] (default 0.9)
+ *
+ * Outputs:       Transactions per second for every shard number
+ ****************************************************************************/
+
+#include <chrono>
+#include <random>
+#include "ShardCoordinator.h"
+
+static vector<Command> makeWorkload(int tranNum, double local, int shardNum) {
+    const int wave = 16, ops = 4;
+    mt19937 rng(7);
+    uniform_real_distribution<double> coin(0.0, 1.0);
+    uniform_int_distribution<var_id> anyVar(1, VAR_NUM);
+    uniform_int_distribution<int> anyShard(0, shardNum - 1);
+
+    vector<Command> cmds;
+    for (int base = 1; base <= tranNum; base += wave) {
+        int last = min(tranNum, base + wave - 1);
+        vector<int> home;
+        for (tran_id t = base; t <= last; ++t) {
+            cmds.push_back({ CommandType::Begin, t, 0, 0 });
+            home.push_back(anyShard(rng));
+        }
+        for (int k = 0; k < ops; ++k) {
+            for (tran_id t = base; t <= last; ++t) {
+                var_id v = anyVar(rng);
+                if (coin(rng) < local) {
+                    while (v % shardNum != home[t - base])
+                        v = anyVar(rng);
+                }
+                if (k % 2 == 0)
+                    cmds.push_back({ CommandType::Read, t, v, 0 });
+                else
+                    cmds.push_back({ CommandType::Write, t, v, t });
+            }
+        }
+        for (tran_id t = base; t <= last; ++t)
+            cmds.push_back({ CommandType::End, t, 0, 0 });
+    }
+    return cmds;
+}
+
+int main(int argc, char** argv) {
+    int tranNum = argc > 1 ? stoi(argv[1]) : 2000;
+    double local = argc > 2 ? stod(argv[2]) : 0.9;
+
+    cout << "transactions: " << tranNum << ", local probability: " << local << endl;
+    for (int shardNum : { 1, 2, 4, 8 }) {
+        vector<Command> cmds = makeWorkload(tranNum, local, shardNum);
+        globalTime = 0.0;
+
+        auto t0 = chrono::steady_clock::now();
+        {
+            ShardCoordinator coordinator(shardNum);     // no sink, results are discarded
+            for (const Command& cmd : cmds) {
+                coordinator.execute(cmd);
+                globalTime += 0.1;
+            }
+        }
+        auto t1 = chrono::steady_clock::now();
+
+        double sec = chrono::duration<double>(t1 - t0).count();
+        cout << "shards " << shardNum << ": " << tranNum / sec << " txn/s (" << sec * 1000 << " ms)" << endl;
+    }
+    return 0;
+}
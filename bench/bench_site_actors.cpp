@@ -0,0 +1,231 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Site actors against direct calls. With 10 to 100 sites:
+ *                 - commit latency: a transaction caches writes of a few
+ *                   replicated variables at every site, then commits them
+ *                   everywhere; one site after the other with direct calls,
+ *                   all sites at once with SiteActors,
+ *                 - read latency: a snapshot read at one site.
+ *                Both ways must leave every site in the same state. Then the
+ *                engine itself (SITE_NUM sites) replays a synthetic workload
+ *                with and without setSiteActors, under write-all and
+ *                majority-quorum replication, and must report the same reads
+ *                and commit outcomes.
+ *
+ * Inputs:        Optional argv[1]: commits per site count (default 2000)
+ *                Optional argv[2]: variables written per commit (default 4)
+ *                Optional argv[3]: engine transactions (default 2000)
+ *
+ * Outputs:       Mean and 99th percentile latency for each way and site
+ *                count, engine throughput for each way and policy
+ ****************************************************************************/
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include "SiteActors.h"
+#include "TransactionManager.h"
+
+using Clock = chrono::steady_clock;
+
+struct Latency {
+    double mean;
+    double p99;
+};
+
+static Latency summarize(vector<double>& us) {
+    double sum = 0.0;
+    for (double u : us)
+        sum += u;
+    sort(us.begin(), us.end());
+    return { sum / us.size(), us[us.size() * 99 / 100] };
+}
+
+// the committed value of every variable of every site
+static vector<int> state(const vector<DataManager*>& sites) {
+    vector<int> values;
+    for (DataManager* site : sites) {
+        for (var_id id = 1; id <= VAR_NUM; ++id)
+            values.push_back(site->hasVariable(id) ? site->getVariables()[id].value : 0);
+    }
+    return values;
+}
+
+// FNV-1a over the reads and commit outcomes, in the order they are reported
+class DigestSink : public ResultSink {
+public:
+    uint64_t digest = 14695981039346656037ull;
+
+    void onRead(const ReadResult& r) override {
+        mix(r.tranID);
+        mix(r.var);
+        mix(r.value);
+        mix(static_cast<int>(r.status));
+    }
+    void onWrite(const WriteResult& r) override {
+        for (site_id s : r.sites)
+            mix(s);
+    }
+    void onCommit(const CommitResult& r) override {
+        mix(r.tranID);
+        mix(r.committed);
+        for (const SiteWrite& w : r.writes)
+            mix(w.site * 1000 + w.var);
+    }
+
+private:
+    void mix(long long v) {
+        digest = (digest ^ static_cast<uint64_t>(v)) * 1099511628211ull;
+    }
+};
+
+static vector<Command> makeWorkload(int tranNum) {
+    mt19937 rng(40);
+    uniform_int_distribution<var_id> anyVar(1, VAR_NUM);
+    uniform_int_distribution<int> roll(0, 99);
+    vector<Command> cmds;
+    auto add = [&cmds](CommandType type, tran_id id, var_id var = 0, int value = 0) {
+        Command cmd;
+        cmd.type = type;
+        cmd.id = id;
+        cmd.var = var;
+        cmd.value = value;
+        cmds.push_back(cmd);
+    };
+    const int wave = 8;
+    for (int base = 1; base <= tranNum; base += wave) {
+        int last = min(tranNum, base + wave - 1);
+        for (tran_id t = base; t <= last; ++t)
+            add(CommandType::Begin, t);
+        for (int k = 0; k < 3; ++k) {
+            for (tran_id t = base; t <= last; ++t) {
+                if (roll(rng) < 40)
+                    add(CommandType::Read, t, anyVar(rng));
+                else
+                    add(CommandType::Write, t, anyVar(rng), t * 10 + k);
+            }
+        }
+        if (roll(rng) < 10) {
+            site_id s = 1 + base % SITE_NUM;
+            add(CommandType::Fail, s);
+            add(CommandType::Recover, s);
+        }
+        for (tran_id t = base; t <= last; ++t)
+            add(CommandType::End, t);
+    }
+    return cmds;
+}
+
+int main(int argc, char** argv) {
+    int commits = argc > 1 ? stoi(argv[1]) : 2000;
+    int width = argc > 2 ? stoi(argv[2]) : 4;
+    int tranNum = argc > 3 ? stoi(argv[3]) : 2000;
+    cout << "cores: " << thread::hardware_concurrency() << ", commits: " << commits
+        << ", variables per commit: " << width << endl;
+
+    bool ok = true;
+    for (size_t siteNum : { 10, 25, 50, 100 }) {
+        vector<unique_ptr<DataManager>> owned[2];
+        vector<DataManager*> sites[2];
+        for (int way = 0; way < 2; ++way) {
+            for (site_id s = 1; s <= static_cast<site_id>(siteNum); ++s) {
+                owned[way].push_back(make_unique<DataManager>(s));
+                sites[way].push_back(owned[way].back().get());
+            }
+        }
+        SiteActors actors(sites[1]);
+        vector<size_t> all;
+        for (size_t i = 0; i < siteNum; ++i)
+            all.push_back(i);
+
+        /**   commit: cache the writes everywhere, then commit them everywhere   **/
+        Latency commit[2];
+        for (int way = 0; way < 2; ++way) {
+            vector<double> us;
+            globalTime = 0.0;
+            for (int c = 1; c <= commits; ++c) {
+                globalTime += 1.0;
+                auto apply = [c, width](DataManager& site) {
+                    for (int k = 0; k < width; ++k)
+                        site.write(c, 2 + 2 * ((c + k) % (VAR_NUM / 2)), c * 100 + k);
+                };
+                auto commitAll = [c, width](DataManager& site) {
+                    for (int k = 0; k < width; ++k)
+                        site.commitWrite(c, 2 + 2 * ((c + k) % (VAR_NUM / 2)), c * 100 + k);
+                };
+                auto t0 = Clock::now();
+                if (way == 0) {
+                    for (DataManager* site : sites[0])
+                        apply(*site);
+                    for (DataManager* site : sites[0])
+                        commitAll(*site);
+                }
+                else {
+                    actors.forEach(all, apply);
+                    actors.forEach(all, commitAll);
+                }
+                us.push_back(chrono::duration<double, micro>(Clock::now() - t0).count());
+            }
+            commit[way] = summarize(us);
+        }
+        bool same = state(sites[0]) == state(sites[1]);
+        ok &= same;
+
+        /**   read: one snapshot read at one site   **/
+        Latency read[2];
+        long long sum[2] = { 0, 0 };
+        for (int way = 0; way < 2; ++way) {
+            mt19937 rng(7);
+            vector<double> us;
+            for (int r = 0; r < commits; ++r) {
+                size_t at = rng() % siteNum;
+                var_id id = 2 + 2 * static_cast<var_id>(rng() % (VAR_NUM / 2));
+                double time = 1.0 + rng() % commits;
+                auto t0 = Clock::now();
+                pair<bool, int> got = way == 0 ? sites[0][at]->read(id, time)
+                    : actors.call(at, [id, time](DataManager& site) { return site.read(id, time); });
+                us.push_back(chrono::duration<double, micro>(Clock::now() - t0).count());
+                sum[way] += got.second;
+            }
+            read[way] = summarize(us);
+        }
+        same &= sum[0] == sum[1];
+        ok &= same;
+
+        cout << siteNum << " sites:" << endl;
+        cout << "  commit  direct " << commit[0].mean << " us (p99 " << commit[0].p99 << "), actors "
+            << commit[1].mean << " us (p99 " << commit[1].p99 << "), " << commit[0].mean / commit[1].mean << "x" << endl;
+        cout << "  read    direct " << read[0].mean << " us (p99 " << read[0].p99 << "), actors "
+            << read[1].mean << " us (p99 " << read[1].p99 << ")" << (same ? "" : "  MISMATCH") << endl;
+    }
+
+    /**   the engine, with and without site actors   **/
+    vector<Command> cmds = makeWorkload(tranNum);
+    for (ReplicationPolicy policy : { ReplicationPolicy::writeAll, ReplicationPolicy::majorityQuorum }) {
+        uint64_t digest[2];
+        double seconds[2];
+        for (int way = 0; way < 2; ++way) {
+            DigestSink sink;
+            TransactionManager manager;
+            manager.setSink(&sink);
+            manager.setReplicationPolicy(policy, 2);
+            manager.setSiteActors(way == 1);
+            globalTime = 0.0;
+            auto t0 = Clock::now();
+            for (const Command& cmd : cmds) {
+                manager.execute(cmd);
+                globalTime += 0.1;
+            }
+            seconds[way] = chrono::duration<double>(Clock::now() - t0).count();
+            digest[way] = sink.digest;
+        }
+        bool same = digest[0] == digest[1];
+        ok &= same;
+        cout << (policy == ReplicationPolicy::writeAll ? "engine, write-all:       " : "engine, majority quorum: ")
+            << tranNum / seconds[0] << " ends/s direct, " << tranNum / seconds[1] << " ends/s actors"
+            << (same ? "" : "  MISMATCH") << endl;
+    }
+    return ok ? 0 : 1;
+}
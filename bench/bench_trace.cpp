@@ -0,0 +1,126 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   Replay benchmark for text vs. binary traces. A synthetic
+ *                text trace (waves of concurrent transactions with reads,
+ *                writes and an occasional site failure) is converted to the
+ *                binary format, then both are
+ *                 - decoded only: parseCommand() per line vs. TraceReader,
+ *                 - replayed into a TransactionManager with no sink.
+ *
+ * Inputs:        Optional argv[1]: number of transactions (default 2000)
+ *                Optional argv[2]: operations per transaction (default 8)
+ *
+ * Outputs:       Trace sizes, and commands per second for both paths
+ ****************************************************************************/
+
+#include <chrono>
+#include <random>
+#include <sstream>
+#include "TransactionManager.h"
+#include "Trace.h"
+
+static string makeTrace(int tranNum, int ops) {
+    const int wave = 16;
+    mt19937 rng(11);
+    uniform_int_distribution<var_id> anyVar(1, VAR_NUM);
+    uniform_int_distribution<site_id> anySite(1, SITE_NUM);
+
+    ostringstream text;
+    for (int base = 1; base <= tranNum; base += wave) {
+        int last = min(tranNum, base + wave - 1);
+        for (tran_id t = base; t <= last; ++t)
+            text << "begin(T" << t << ")\n";
+        for (int k = 0; k < ops; ++k) {
+            for (tran_id t = base; t <= last; ++t) {
+                if (k % 2 == 0)
+                    text << "R(T" << t << ",x" << anyVar(rng) << ")\n";
+                else
+                    text << "W(T" << t << ",x" << anyVar(rng) << "," << t * 10 + k << ")\n";
+            }
+        }
+        if (base % (wave * 8) == 1) {
+            site_id s = anySite(rng);
+            text << "fail(" << s << ")\nrecover(" << s << ")\n";
+        }
+        for (tran_id t = base; t <= last; ++t)
+            text << "end(T" << t << ")\n";
+    }
+    return text.str();
+}
+
+static double seconds(chrono::steady_clock::time_point since) {
+    return chrono::duration<double>(chrono::steady_clock::now() - since).count();
+}
+
+int main(int argc, char** argv) {
+    int tranNum = argc > 1 ? stoi(argv[1]) : 2000;
+    int ops = argc > 2 ? stoi(argv[2]) : 8;
+
+    string text = makeTrace(tranNum, ops);
+    istringstream textIn(text);
+    ostringstream binaryOut;
+    size_t commands = TraceWriter::convert(textIn, binaryOut);
+    string binary = binaryOut.str();
+    cout << "commands: " << commands << endl;
+    cout << "size:     text " << text.size() << " bytes, binary " << binary.size() << " bytes ("
+        << 100.0 * binary.size() / text.size() << "%)" << endl;
+
+    /**   decode only   **/
+    const int rounds = 5;
+    long long checksum = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        istringstream in(text);
+        string line;
+        while (getline(in, line))
+            checksum += parseCommand(line).id;
+    }
+    double textDecode = seconds(t0);
+
+    t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        istringstream in(binary);
+        TraceReader reader(in);
+        Command cmd;
+        double time;
+        while (reader.next(cmd, time))
+            checksum -= cmd.id;
+    }
+    double binaryDecode = seconds(t0);
+    cout << "decode:   text " << rounds * commands / textDecode << " cmd/s, binary "
+        << rounds * commands / binaryDecode << " cmd/s (" << textDecode / binaryDecode << "x)" << endl;
+
+    /**   full replay   **/
+    t0 = chrono::steady_clock::now();
+    {
+        TransactionManager manager;     // no sink, results are discarded
+        istringstream in(text);
+        string line;
+        globalTime = 0.0;
+        while (getline(in, line)) {
+            manager.inputHandle(line);
+            globalTime += 0.1;
+        }
+    }
+    double textReplay = seconds(t0);
+
+    t0 = chrono::steady_clock::now();
+    {
+        TransactionManager manager;
+        istringstream in(binary);
+        TraceReader reader(in);
+        Command cmd;
+        double time;
+        while (reader.next(cmd, time)) {
+            globalTime = time;
+            manager.execute(cmd);
+        }
+    }
+    double binaryReplay = seconds(t0);
+    cout << "replay:   text " << commands / textReplay << " cmd/s, binary "
+        << commands / binaryReplay << " cmd/s (" << textReplay / binaryReplay << "x)" << endl;
+    cout << "checksum: " << checksum << endl;     // 0 when both decoders agree
+    return 0;
+}
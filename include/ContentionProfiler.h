@@ -0,0 +1,58 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the ContentionProfiler class, which
+ *                tracks the variables behind conflicts and aborts: RW and WW
+ *                edges found by reads and writes, SSI cycle aborts and
+ *                first-committer-wins aborts.
+ *
+ *                It is a Space-Saving heavy-hitters sketch: a fixed number of
+ *                slots, each counting one variable. A variable not in the
+ *                sketch takes over the slot with the lowest count and starts
+ *                from that count, so memory stays bounded however many keys
+ *                there are; any variable with more events than
+ *                total / capacity is guaranteed a slot, and a count is never
+ *                more than its error above the true number of events. The
+ *                per-event attribution is exact since the variable took its
+ *                slot. Slots form a min-heap on the count, so an event costs
+ *                O(log capacity).
+ ****************************************************************************/
+
+#ifndef ContentionProfiler_H
+#define ContentionProfiler_H
+#include "common.h"
+#include "Result.h"
+
+class ContentionProfiler {
+public:
+    enum Event {
+        rwEdge,
+        wwEdge,
+        cycleAbort,
+        firstCommitterAbort
+    };
+
+    static constexpr size_t defaultTop = 5;     // variables reported by a bare contention command
+
+    ContentionProfiler(size_t capacity = 64);
+    void record(var_id varID, Event event);
+    void record(const var_set& vars, Event event);     // one event per variable
+    vector<HotVariable> top(size_t k) const;            // hottest first
+    size_t getTotal() const;
+
+    // higher count first, then the smaller error, then the lower variable
+    static bool hotter(const HotVariable& a, const HotVariable& b);
+
+private:
+    size_t capacity;
+    size_t total = 0;
+    vector<HotVariable> slots;                  // min-heap on count
+    unordered_map<var_id, size_t> position;     // variable -> slot index
+
+    void place(size_t i);
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+};
+
+#endif
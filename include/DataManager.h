@@ -1,27 +1,30 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-02-2024
- * Last Edited:   12-07-2024
+ * Last Edited:   10-19-2026
  * Description:   This header file defines the DataManager class and its 
  *                associated structures. The DataManager is responsible for 
  *                managing site-level data in a distributed database system. 
  *                Key components include:
  *                 - The site identifier (siteID).
  *                 - The site status, including availability and failure times.
- *                 - A list of stored variables with their version history.
+ *                 - A list of stored variables with their version history,
+ *                   readable without locks (VersionChain).
  *                 - A local write cache for uncommitted transaction data.
  ****************************************************************************/
 
 #ifndef DataManager_H
 #define DataManager_H
+#include <atomic>
 #include "common.h"
+#include "VersionChain.h"
 
 class DataManager {
 public:
     struct Variable {
         int value;                          // Committed value
         double lastCommitTime;                  // Last commit timestamp
-        map<double, int> versionHistory; // Historical versions (timestamp -> value)
+        VersionChain versionHistory;        // Historical versions, lock-free for readers
     };
     struct SiteStatus {
         bool available;
@@ -31,9 +34,16 @@ public:
 
     DataManager(site_id id);
     pair<bool, int> read(const var_id variable, const double startTime);
+    vector<pair<bool, int>> readBatch(const vector<var_id>& variables, const double startTime);
+    pair<double, int> readAt(const var_id variable, const double time) const;
+    bool wasUp(const double from, const double to) const;
+    size_t pruneVersions(const double before);
     bool write(tran_id tranID, const var_id var, int value);
-    void commitWrite(const tran_id tranID, const var_id var, const int value);
+    vector<bool> writeBatch(const tran_id tranID, const vector<pair<var_id, int>>& writes);
+    bool commitWrite(const tran_id tranID, const var_id var, const int value);
     void abortWrite(const tran_id tranID);
+    void discardWrite(const tran_id tranID, const var_id var);
+    void applyReplicated(const var_id var, const int value, const double commitTime);
     bool isAvailable() const;
     bool hasVariable(var_id variable) const;
     site_id getSiteID() const;
@@ -43,12 +53,17 @@ public:
     void clearCache();
     const unordered_map<var_id, int>& getCacheWrite(tran_id tranID) const;
     const std::unordered_map<tran_id, std::unordered_map<var_id, int>>& getAllCacheWrites() const;
+    size_t getRequestCount() const;
 
 private:
     site_id siteID;
     SiteStatus status;
     unordered_map<var_id, Variable> variables;
     unordered_map<tran_id, unordered_map<var_id, int>> cacheWrites;
+    atomic<size_t> requests{ 0 };   // read/write/commit/abort/replicate calls received
+    vector<pair<double, double>> downtime;      // [fail, recover) intervals
+
+    pair<bool, int> readVersion(const var_id variable, const double startTime);
 };
 
 #endif
\ No newline at end of file
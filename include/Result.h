@@ -0,0 +1,161 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the typed results of the engine
+ *                and the ResultSink callback interface they are reported to.
+ *                TransactionManager returns results from its operations and
+ *                also reports every result to its sink, in execution order:
+ *                 - ReadResult: value read, or blocked / aborted status.
+ *                 - WriteResult: sites that cached the write.
+ *                 - CommitResult: outcome of end(), the abort reason and the
+ *                   writes applied at every site.
+ *                 - HistoryRead: value of a variable at a past time (readAt).
+ *                 - Site snapshots (dump), replication lag (lag),
+ *                   admission control counters (admission) and the
+ *                   variables with the most contention (contention).
+ *                The engine never prints; TextPrinter formats results in the
+ *                text format of the command line program.
+ ****************************************************************************/
+
+#ifndef Result_H
+#define Result_H
+#include <functional>
+#include "common.h"
+
+enum class ReadStatus {
+    ok,
+    blocked,        // waiting for a failed site, see waitSites
+    aborted,        // no site can serve the read
+    unknown         // no such transaction
+};
+
+enum class AbortReason {
+    none,
+    noReplica,      // a read found no site to read from
+    blockedRead,    // ended while waiting for a failed site
+    siteFailure,    // a site it wrote to failed before commit
+    noQuorum,       // too few replicas available for a quorum commit
+    cycle,          // commit would close a cycle in the serialization graph
+    firstCommitter, // lost a write-write conflict to an earlier committer
+    timeout,        // blocked on a failed site for longer than the admission timeout
+    unknown         // no such transaction, or already aborted
+};
+
+struct ReadResult {
+    tran_id tranID;
+    var_id var;
+    ReadStatus status;
+    int value = 0;
+    vector<site_id> waitSites;
+    bool resumed = false;       // served by recover() after being blocked
+};
+
+struct WriteResult {
+    tran_id tranID;
+    var_id var;
+    int value;
+    vector<site_id> sites;      // sites that cached the write, empty when it failed
+};
+
+struct SiteWrite {
+    site_id site;
+    var_id var;
+    int value;
+};
+
+struct CommitResult {
+    tran_id tranID;
+    bool committed;
+    AbortReason reason = AbortReason::none;
+    vector<SiteWrite> writes;   // applied synchronously at commit
+};
+
+// value of a variable at a past time, read outside any transaction
+struct HistoryRead {
+    var_id var;
+    double time;
+    bool found;         // false when no live replica has a complete history up to time
+    int value = 0;
+    site_id site = 0;   // replica that served the read
+};
+
+struct SiteSnapshot {
+    site_id site;
+    vector<pair<var_id, int>> values;   // sorted by variable
+};
+
+struct ReplicaStats {
+    site_id site;
+    size_t pending;
+    size_t applied;
+    double lag;
+    double maxLag;
+};
+
+// admission control counters; queue wait is averaged over every admitted begin
+struct AdmissionStats {
+    size_t active;          // live transactions, blocked included
+    size_t blocked;
+    size_t queued;          // begins waiting for admission
+    size_t admitted;
+    size_t rejected;
+    size_t timedOut;
+    double meanQueueWait;
+    double maxQueueWait;
+};
+
+// conflicts and aborts attributed to one variable; count is a Space-Saving
+// estimate of the events, at most error above the true number
+struct HotVariable {
+    var_id var;
+    size_t count;
+    size_t error;
+    size_t rwEdges;
+    size_t wwEdges;
+    size_t cycleAborts;
+    size_t firstCommitterAborts;
+};
+
+// receives results as they happen; every callback defaults to doing nothing
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+    virtual void onRead(const ReadResult&) {}
+    virtual void onWrite(const WriteResult&) {}
+    virtual void onCommit(const CommitResult&) {}
+    virtual void onHistory(const HistoryRead&) {}
+    virtual void onDump(const vector<SiteSnapshot>&) {}
+    virtual void onLag(const vector<ReplicaStats>&) {}
+    virtual void onAdmission(const AdmissionStats&) {}
+    virtual void onContention(const vector<HotVariable>&) {}
+    virtual void onMessage(const string&) {}    // diagnostics: bad input, unknown ids, queryState
+};
+
+// records results to hand them to another sink later, in the same order
+class ResultLog : public ResultSink {
+public:
+    void onRead(const ReadResult& r) override { record([r](ResultSink& s) { s.onRead(r); }); }
+    void onWrite(const WriteResult& r) override { record([r](ResultSink& s) { s.onWrite(r); }); }
+    void onCommit(const CommitResult& r) override { record([r](ResultSink& s) { s.onCommit(r); }); }
+    void onHistory(const HistoryRead& r) override { record([r](ResultSink& s) { s.onHistory(r); }); }
+    void onDump(const vector<SiteSnapshot>& r) override { record([r](ResultSink& s) { s.onDump(r); }); }
+    void onLag(const vector<ReplicaStats>& r) override { record([r](ResultSink& s) { s.onLag(r); }); }
+    void onAdmission(const AdmissionStats& r) override { record([r](ResultSink& s) { s.onAdmission(r); }); }
+    void onContention(const vector<HotVariable>& r) override { record([r](ResultSink& s) { s.onContention(r); }); }
+    void onMessage(const string& r) override { record([r](ResultSink& s) { s.onMessage(r); }); }
+
+    void replay(ResultSink& sink) const {
+        for (const auto& entry : entries)
+            entry(sink);
+    }
+
+private:
+    vector<function<void(ResultSink&)>> entries;
+
+    void record(function<void(ResultSink&)> entry) {
+        entries.push_back(move(entry));
+    }
+};
+
+#endif
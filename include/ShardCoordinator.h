@@ -0,0 +1,106 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the ShardCoordinator class, which
+ *                runs the database in partitioned mode. The variable space is
+ *                split across several TransactionManager shards (variable x
+ *                belongs to shard x % shardNum), each with its own sites and
+ *                serialization graph, running on its own worker thread.
+ *
+ *                Key responsibilities include:
+ *                 - Routing commands to the owning shard, beginning a
+ *                   transaction lazily on every shard it touches.
+ *                 - Committing transactions that span several shards through
+ *                   two-phase commit (prepare / commit / abort).
+ *                 - Exchanging dependencies between shards (paths between
+ *                   distributed transactions) so SSI cycles that cross
+ *                   shards are still detected.
+ *                 - Reporting all results to its sink in input order.
+ *                 - Merging the contention profiles of the shards, which
+ *                   own disjoint variables.
+ ****************************************************************************/
+
+#ifndef ShardCoordinator_H
+#define ShardCoordinator_H
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <future>
+#include "common.h"
+#include "TransactionManager.h"
+#include "Result.h"
+
+class ShardCoordinator {
+public:
+    ShardCoordinator(int shardNum, ResultSink* sink = nullptr);
+    ~ShardCoordinator();
+    void setSink(ResultSink* s);
+    void inputHandle(const string& inputs);
+    void execute(const Command& cmd);
+    void flush();
+    int getShardNum() const;
+    vector<HotVariable> hotVariables(size_t k);
+
+private:
+    // results of one shard task or of the coordinator, replayed in order
+    struct Segment {
+        ResultLog log;
+        atomic<bool> done{ false };
+    };
+
+    struct Shard {
+        TransactionManager manager;
+        unordered_set<tran_id> distributed;     // transactions also living on other shards, worker only
+        thread worker;
+        mutex lock;
+        condition_variable ready;
+        condition_variable idle;
+        deque<function<void()>> tasks;
+        size_t pending = 0;     // queued + running tasks
+        bool stopping = false;
+    };
+
+    struct Transaction {
+        double startTime;
+        vector<int> shards;     // shards the transaction has begun on, in order
+        bool finished = false;
+    };
+
+    // result of end() on the only shard a transaction lives on
+    enum EndResult {
+        localCommit,
+        localAbort,
+        needGlobal,
+        unknown         // already aborted by the shard, e.g. no site to read from
+    };
+
+    vector<unique_ptr<Shard>> shards;
+    unordered_map<tran_id, Transaction> transList;
+    unordered_set<tran_id> committedDistributed;
+    bool siteAvailable[SITE_NUM + 1];
+    deque<shared_ptr<Segment>> segments;
+    ResultSink* sink;
+
+    int shardOf(var_id varID) const;
+    void run(Shard* shard);
+    void enqueue(int shardID, function<void(ResultSink&)> task);
+    void waitIdle(int shardID);
+    void barrier();
+    ResultSink& note();
+    void emit();
+
+    void touch(tran_id tranID, int shardID);
+    void endTransaction(tran_id tranID);
+    void endLocal(tran_id tranID, int shardID);
+    void endDistributed(tran_id tranID);
+    bool crossShardCycle(tran_id tranID);
+    void finish(tran_id tranID, AbortReason reason);
+    void dump(double time);
+};
+
+#endif
@@ -0,0 +1,102 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the Simulator class, a discrete-
+ *                event simulation of the database with remote sites. Each
+ *                site sits behind a link with its own latency, bandwidth and
+ *                jitter; all time is virtual and advanced by an event queue.
+ *
+ *                Key components include:
+ *                 - Links: every request a command sends to a site costs one
+ *                   round trip on that site's link. Requests to different
+ *                   sites go out in parallel, requests to one site in series.
+ *                 - Clients: every transaction of the trace is a client that
+ *                   sends its next command once the previous one returned,
+ *                   and waits while it is blocked on a failed site.
+ *                 - Failures: fail/recover lines of the trace, plus random
+ *                   failures per site when a mean time between failures is
+ *                   given.
+ *                 - Admission: clients whose begin is queued wait like
+ *                   blocked ones until the TransactionManager admits them.
+ *                 - Metrics: commit latency, abort rate, request count,
+ *                   rejections, blocked timeouts and queue wait.
+ ****************************************************************************/
+
+#ifndef Simulator_H
+#define Simulator_H
+#include <queue>
+#include <random>
+#include "common.h"
+#include "TransactionManager.h"
+
+class Simulator {
+public:
+    struct Link {
+        double latency = 2.0;       // one way, virtual ms
+        double bandwidth = 1000.0;  // bytes per virtual ms
+        double jitter = 1.0;        // extra delay, uniform in [0, jitter)
+    };
+    struct Config {
+        vector<Link> links = vector<Link>(SITE_NUM + 1);
+        double arrival = 1.0;       // virtual ms between trace lines
+        double think = 0.5;         // client pause between two commands
+        double requestSize = 64.0;  // bytes per request and per reply
+        double mtbf = 0.0;          // mean time between failures per site, 0 = none
+        double mttr = 50.0;         // mean time to recover
+        unsigned seed = 1;
+        TransactionManager::AdmissionConfig admission;     // limits and blocked timeout, in virtual ms
+    };
+    struct Metrics {
+        size_t commits = 0;
+        size_t aborts = 0;
+        size_t stuck = 0;           // still blocked when the simulation ended
+        size_t requests = 0;
+        size_t failures = 0;
+        vector<double> latencies;   // begin to end reply, committed transactions
+        double endTime = 0.0;
+    };
+
+    Simulator(const Config& config);
+    void load(istream& trace);
+    void run();
+    const Metrics& getMetrics() const;
+    void report(ostream& os) const;
+
+private:
+    enum EventKind {
+        client,     // next command of a transaction
+        global,     // fail/recover/dump... line of the trace
+        failure,    // random site failure
+        recovery    // random site recovery
+    };
+    struct Event {
+        double time;
+        size_t seq;
+        EventKind kind;
+        Command cmd;
+        bool operator>(const Event& other) const {
+            return time != other.time ? time > other.time : seq > other.seq;
+        }
+    };
+
+    Config config;
+    Metrics metrics;
+    TransactionManager manager;
+    mt19937 rng;
+    priority_queue<Event, vector<Event>, greater<Event>> events;
+    size_t seq = 0;
+    size_t workload = 0;            // client and global events still to run
+    unordered_map<tran_id, deque<Command>> clients;
+    unordered_map<tran_id, double> beginTime;
+    unordered_set<tran_id> parked;  // blocked on a failed site or waiting for admission
+
+    void add(const Command& cmd, double time);
+    void schedule(double time, EventKind kind, const Command& cmd);
+    double execute(const Command& cmd);
+    void next(tran_id tranID, double time);
+    void resume(double time);
+    void scheduleFailure(site_id siteID, double after);
+};
+
+#endif
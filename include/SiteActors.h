@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the SiteActors class, which runs
+ *                every DataManager on a worker thread of its own.
+ *
+ *                The caller sends a site requests through a bounded lock-free
+ *                single-producer queue, the site's actor runs them in order,
+ *                and the replies of all actors come back through one bounded
+ *                lock-free multi-producer queue. forEach() sends a request to
+ *                several sites at once and returns when all have replied, so
+ *                replica operations run in parallel instead of one site
+ *                after the other.
+ *
+ *                While the actors run, only requests change a site. Between
+ *                two calls every actor is idle and the caller may still read
+ *                a site directly (isAvailable, hasVariable, ...), since the
+ *                replies order the actors' work before it. Requests run with
+ *                the caller's clock (globalTime).
+ *
+ *                Both sides poll a little, yielding the core, before they
+ *                sleep, which saves most wake-ups when requests come in
+ *                bursts. On Linux, actor i is pinned to core i modulo the
+ *                number of cores.
+ ****************************************************************************/
+
+#ifndef SiteActors_H
+#define SiteActors_H
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "common.h"
+#include "DataManager.h"
+
+class SiteActors {
+public:
+    // one actor per site, at most capacity requests waiting for each
+    SiteActors(const vector<DataManager*>& sites, size_t capacity = 64, bool pin = true);
+    ~SiteActors();
+    SiteActors(const SiteActors&) = delete;
+    SiteActors& operator=(const SiteActors&) = delete;
+
+    size_t size() const;
+
+    // runs f(site) on the actors of the listed sites (positions in the
+    // constructor's vector) at the same time and returns when all are done;
+    // f is shared by them, so each call should only write its own slots
+    template <class F>
+    void forEach(const vector<size_t>& which, F&& f) {
+        for (size_t i : which)
+            post(i, &SiteActors::invoke<remove_reference_t<F>>, const_cast<void*>(static_cast<const void*>(&f)));
+        gather(which.size());
+    }
+
+    // f(site) on the actor of one site, returns its result
+    template <class F>
+    auto call(size_t index, F&& f) -> decltype(f(declval<DataManager&>())) {
+        using R = decltype(f(declval<DataManager&>()));
+        if constexpr (is_void_v<R>) {
+            post(index, &SiteActors::invoke<remove_reference_t<F>>, const_cast<void*>(static_cast<const void*>(&f)));
+            gather(1);
+        }
+        else {
+            R result{};
+            auto run = [&f, &result](DataManager& site) { result = f(site); };
+            post(index, &SiteActors::invoke<decltype(run)>, &run);
+            gather(1);
+            return result;
+        }
+    }
+
+private:
+    using Task = void (*)(DataManager&, void*);
+    struct Request {
+        Task fn;
+        void* arg;
+        double time;        // the caller's globalTime
+    };
+
+    // bounded single-producer single-consumer ring, the caller to one actor
+    class RequestQueue {
+    public:
+        explicit RequestQueue(size_t capacity);
+        bool push(const Request& r);
+        bool pop(Request& r);
+        bool empty() const;
+
+    private:
+        vector<Request> slots;
+        size_t mask;
+        alignas(64) atomic<size_t> head{ 0 };      // next slot to pop, owned by the actor
+        alignas(64) atomic<size_t> tail{ 0 };      // next slot to push, owned by the caller
+    };
+
+    // bounded multi-producer single-consumer queue (per-cell sequence
+    // numbers), the actors to the caller
+    class ReplyQueue {
+    public:
+        explicit ReplyQueue(size_t capacity);
+        bool push(size_t actor);
+        bool pop(size_t& actor);
+
+    private:
+        struct Cell {
+            atomic<size_t> seq;
+            size_t actor;
+        };
+        unique_ptr<Cell[]> cells;
+        size_t mask;
+        alignas(64) atomic<size_t> tail{ 0 };      // shared by the actors
+        alignas(64) size_t head = 0;               // owned by the caller
+    };
+
+    struct Actor {
+        DataManager* site;
+        RequestQueue queue;
+        atomic<bool> sleeping{ false };
+        mutex lock;
+        condition_variable wake;
+        thread worker;
+
+        Actor(DataManager* site, size_t capacity) : site(site), queue(capacity) {}
+    };
+
+    vector<unique_ptr<Actor>> actors;
+    ReplyQueue replies;
+    atomic<bool> stopping{ false };
+    atomic<bool> callerSleeping{ false };
+    mutex callerLock;
+    condition_variable callerWake;
+    const int spins = 64;           // polls, yielding the core, before sleeping
+
+    template <class F>
+    static void invoke(DataManager& site, void* arg) {
+        (*static_cast<F*>(arg))(site);
+    }
+    void post(size_t index, Task fn, void* arg);
+    void gather(size_t count);
+    void run(Actor& actor, size_t index);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the SnapshotExport class, which
+ *                writes a point-in-time copy of every site to a stream on
+ *                background threads.
+ *
+ *                Workers take a run of sites at a time and read them at
+ *                the snapshot time through the lock-free version chains, so
+ *                the engine keeps committing while they run; a version
+ *                committed after the snapshot time is never seen. A writer
+ *                thread streams the finished runs in site order, and workers
+ *                stay at most a few runs ahead of it, so memory does not grow
+ *                with the number of sites.
+ *
+ *                Formats:
+ *                 - text: the dump lines of the command line program
+ *                   ("site 1 - x2: 20, ..."), as TextPrinter prints them.
+ *                 - binary: magic "RCS1", the snapshot time as a raw
+ *                   little-endian double, the site count, then one block per
+ *                   site: its id, the number of values, the variable column
+ *                   (delta varints) and the value column (zigzag varints).
+ ****************************************************************************/
+
+#ifndef SnapshotExport_H
+#define SnapshotExport_H
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "common.h"
+#include "DataManager.h"
+#include "Result.h"
+
+enum class ExportFormat {
+    text,
+    binary
+};
+
+class SnapshotExport {
+public:
+    struct Stats {
+        size_t sites;
+        size_t values;
+        size_t bytes;
+        size_t threads;     // workers, the writer not counted
+        double seconds;
+    };
+
+    // starts exporting at once; sites and out must outlive the export, and
+    // versions at or before time must not be pruned until it is done.
+    // threads = 0 picks one per core, at most one per site
+    SnapshotExport(const vector<DataManager*>& sites, double time, ostream& out, ExportFormat format, size_t threads = 0);
+    ~SnapshotExport();
+    SnapshotExport(const SnapshotExport&) = delete;
+    SnapshotExport& operator=(const SnapshotExport&) = delete;
+
+    Stats wait();                   // blocks until the stream is written
+    double getTime() const;
+
+    // the sites of a binary export; false on a bad magic or a truncated block
+    static bool read(istream& in, double& time, vector<SiteSnapshot>& snapshot);
+
+private:
+    vector<DataManager*> sites;
+    double time;
+    ostream& out;
+    ExportFormat format;
+    size_t chunk;                   // sites per run
+    size_t window;                  // runs encoded ahead of the writer
+
+    mutex lock;
+    condition_variable changed;
+    vector<string> blocks;          // encoded runs not written yet
+    vector<bool> ready;
+    size_t written = 0;
+    size_t nextRun = 0;
+    size_t values = 0;
+    size_t bytes = 0;
+
+    vector<thread> workers;
+    thread writer;
+    Stats stats = {};
+    bool done = false;
+    chrono::steady_clock::time_point started;
+
+    void work();
+    void writeAll();
+    SiteSnapshot snapshotOf(DataManager* site) const;
+    void encode(const SiteSnapshot& site, string& block) const;
+};
+
+#endif
@@ -0,0 +1,32 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the TextPrinter class, a
+ *                ResultSink that writes results in the text format of the
+ *                command line program ("x1: 10", "T1 commits", dump lines).
+ ****************************************************************************/
+
+#ifndef TextPrinter_H
+#define TextPrinter_H
+#include "common.h"
+#include "Result.h"
+
+class TextPrinter : public ResultSink {
+public:
+    TextPrinter(ostream& out);
+    void onRead(const ReadResult& r) override;
+    void onWrite(const WriteResult& r) override;
+    void onCommit(const CommitResult& r) override;
+    void onHistory(const HistoryRead& r) override;
+    void onDump(const vector<SiteSnapshot>& sites) override;
+    void onLag(const vector<ReplicaStats>& stats) override;
+    void onAdmission(const AdmissionStats& stats) override;
+    void onContention(const vector<HotVariable>& hot) override;
+    void onMessage(const string& message) override;
+
+private:
+    ostream& out;
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the compact binary trace format
+ *                and its TraceWriter / TraceReader classes. A binary trace
+ *                holds parsed Commands, so it replays with no text parsing.
+ *
+ *                Layout:
+ *                 - Header: magic "RCT1", then the tick length as a raw
+ *                   little-endian double (0.1, the time between two lines of
+ *                   a text trace).
+ *                 - Records: one opcode byte (the CommandType), the record
+ *                   time, then the operands of that command.
+ *                 - Time: a varint n. n = 2k advances the previous record
+ *                   time by k ticks, one addition per tick, so replayed
+ *                   times are bit-identical to a text replay; n = 1 means a
+ *                   raw double follows instead.
+ *                 - Operands: ids, variables and counts are unsigned
+ *                   varints, values are zigzag varints, times (readAt,
+ *                   dump(t), admission timeout) are raw doubles.
+ ****************************************************************************/
+
+#ifndef Trace_H
+#define Trace_H
+#include <cstdint>
+#include "common.h"
+
+class TraceWriter {
+public:
+    TraceWriter(ostream& out, double tick = 0.1);
+    void write(const Command& cmd, double time);
+    size_t getCount() const;
+
+    // text trace to binary, one tick per line as in the command line program;
+    // lines that do not parse are reported to errors and left out
+    static size_t convert(istream& text, ostream& out, vector<string>* errors = nullptr);
+
+private:
+    ostream& out;
+    double tick;
+    double last = 0.0;
+    size_t count = 0;
+
+    void putVarint(uint64_t v);
+    void putSigned(int64_t v);
+    void putDouble(double v);
+};
+
+class TraceReader {
+public:
+    TraceReader(istream& in);
+    bool isValid() const;
+    double getTick() const;
+    bool next(Command& cmd, double& time);     // false at the end or on a truncated record
+
+    static bool isBinary(istream& in);         // peeks at the magic, keeps the stream position
+
+private:
+    istream& in;
+    bool valid = false;
+    double tick = 0.1;
+    double last = 0.0;
+
+    bool getVarint(uint64_t& v);
+    bool getInt(int& v);
+    bool getSigned(int& v);
+    bool getDouble(double& v);
+};
+
+#endif
@@ -1,7 +1,7 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-02-2024
- * Last Edited:   12-08-2024
+ * Last Edited:   10-19-2026
  * Description:   This header file defines the TransactionManager class, which 
  *                acts as the master node in a distributed database system. 
  *                The TransactionManager is responsible for managing all 
@@ -9,24 +9,52 @@
  *                serialization graph used for conflict detection. 
  * 
  *                Key responsibilities include:
- *                 - Handling transaction lifecycle (begin, read, write, end).
+ *                 - Handling transaction lifecycle (begin, read, write, end),
+ *                   including multi-variable batch reads and writes.
  *                 - Managing site failures and recoveries.
  *                 - Interfacing with the DataManager for site-level data 
  *                   operations and the SerializationGraph for dependency tracking.
  *                 - Maintaining a list of active transactions and their states.
+ *                 - Admission control: limits on live and blocked transactions,
+ *                   a queue for begins over the limit, and a timeout that
+ *                   aborts transactions blocked on a failed site.
+ *                 - Contention profiling: the variables behind conflict
+ *                   edges and aborts, see ContentionProfiler.
+ *                 - Commit batching: a burst of end commands is collected and
+ *                   validated with one pass over the serialization graph,
+ *                   with the same results as ending them one at a time.
+ *                 - Snapshot export: a point-in-time copy of every site,
+ *                   written in the background, see SnapshotExport.
+ *                 - Site actors: optionally, every site runs on a thread of
+ *                   its own and replica operations are sent to all sites at
+ *                   once, with the same results as direct calls, see
+ *                   SiteActors.
  ****************************************************************************/
 
 #ifndef TransactionManager_H
 #define TransactionManager_H
 #include "common.h"
+#include "ContentionProfiler.h"
 #include "DataManager.h"
+#include <memory>
 #include "graph.h"
+#include "Result.h"
+#include "SiteActors.h"
+#include "SnapshotExport.h"
 
 enum TranStatus {
     active,
     committed,
     aborted,
-    blocked
+    blocked,
+    queued      // begin is waiting for admission
+};
+
+// how commits reach the replicas of a replicated variable
+enum class ReplicationPolicy {
+    writeAll,           // every available site, synchronously
+    majorityQuorum,     // a majority synchronously, the rest in background
+    primaryAsync        // first available site synchronously, the rest in background
 };
 
 class TransactionManager {
@@ -37,27 +65,123 @@ public:
         TranStatus status;
         unordered_set<var_id> read;
         unordered_map<var_id, pair<int, double>> write;
+        var_set readMask;       // bitset signature of read, used for conflict checks
+        var_set writeMask;      // bitset signature of write, used for conflict checks
+    };
+
+    // committed updates a follower site has not applied yet
+    struct ReplicaLog {
+        struct Entry {
+            var_id var;
+            int value;
+            double commitTime;
+        };
+        deque<Entry> pending;                       // in commit order
+        unordered_map<var_id, int> pendingPerVar;
+        size_t applied = 0;
+        double maxLag = 0.0;
+    };
+
+    // limits on concurrent transactions, 0 means no limit
+    struct AdmissionConfig {
+        size_t maxActive = 0;           // live transactions, blocked included
+        size_t maxBlocked = 0;          // new begins wait while this many are blocked
+        double blockedTimeout = 0.0;    // abort a transaction blocked this long, 0 = wait for recover
+        long maxQueued = -1;            // begins waiting for admission, -1 = no limit, 0 = reject at once
     };
 
     TransactionManager();
+    ~TransactionManager();
+    void setSink(ResultSink* s);
     void inputHandle(const string &inputs);
+    void execute(const Command& cmd);
     void beginTransaction(tran_id tranID);
-    void readTransaction(const tran_id tranID, const var_id variable);
-    void writeTransaction(const tran_id tranID, const var_id variable, const int value);
-    void endTransaction(tran_id tranID);
+    void beginTransaction(tran_id tranID, double startTime);
+    ReadResult readTransaction(const tran_id tranID, const var_id variable);
+    WriteResult writeTransaction(const tran_id tranID, const var_id variable, const int value);
+    vector<ReadResult> readBatch(const tran_id tranID, const vector<var_id>& variables);
+    vector<WriteResult> writeBatch(const tran_id tranID, const vector<pair<var_id, int>>& writes);
+    CommitResult endTransaction(tran_id tranID);
     void fail(site_id siteID);
     void recover(site_id siteID);
-    void dump();
+    vector<SiteSnapshot> dump();
+    vector<SiteSnapshot> dumpAt(double time);
+    // every site as of time, now when negative, written by background threads
+    // while the manager keeps running; later commits must come at later times
+    unique_ptr<SnapshotExport> exportSnapshot(ostream& out, ExportFormat format, double time = -1.0, size_t threads = 0);
+    HistoryRead readAt(var_id varID, double time);
     void queryState();
+    void setReplicationPolicy(ReplicationPolicy p, int batch);
+    vector<ReplicaStats> replicationLag();
+    void setAdmission(const AdmissionConfig& config);
+    AdmissionStats admissionStats() const;
+    vector<HotVariable> hotVariables(size_t k) const;
+
+    // ends collected before validation, 1 = each end is validated as it arrives;
+    // collected ends take effect at the next other command or flush()
+    void setCommitBatch(size_t n);
+    void flush();
+
+    // run every site on its own thread (SiteActors), or call them directly
+    void setSiteActors(bool on);
+
+    // two-phase commit participant, outcome is reported by the coordinator
+    AbortReason prepareTransaction(const tran_id tranID);
+    vector<SiteWrite> commitPrepared(const tran_id tranID);
+    void abortPrepared(const tran_id tranID);
+
+    bool hasTransaction(tran_id tranID) const;
+    TranStatus getStatus(tran_id tranID) const;
+    double getStartTime(tran_id tranID) const;
+    DataManager* getSite(site_id siteID) const;
+    vector<pair<tran_id, tran_id>> getPortalPaths(const tran_id tranID, const unordered_set<tran_id>& portals) const;
 
 private:
+    ResultSink* sink;
     SerializationGraph tranGraph;
     unordered_map<tran_id, Transaction> transList;
     vector<DataManager*> sites;
+    ReplicationPolicy policy = ReplicationPolicy::writeAll;
+    int batchSize = 1;
+    vector<ReplicaLog> replicaLogs = vector<ReplicaLog>(SITE_NUM + 1);
+    AdmissionConfig admission;
+    AdmissionStats admitStats = {};     // counters only, the rest is filled in by admissionStats()
+    double totalQueueWait = 0.0;
+    size_t committedCount = 0;                          // committed entries of transList
+    map<tran_id, double> blockedSince;                  // blocked transactions, by id
+    deque<pair<tran_id, double>> admissionQueue;        // queued begins and their request time
+    unordered_map<tran_id, deque<Command>> heldCommands;    // commands of queued transactions
+    ContentionProfiler contention;
+    unordered_map<tran_id, Status> statusIndex;         // committed and active entries of transList
+    unordered_set<tran_id> live;                        // entries of transList not committed
+
+    // an end collected for the next batch, with the time it arrived
+    struct PendingEnd {
+        tran_id tranID;
+        double time;
+    };
+    size_t commitBatch = 1;
+    vector<PendingEnd> pendingEnds;
+    unique_ptr<SiteActors> actors;      // null when sites are called directly
+
+    void dispatch(const Command& cmd);
+    template <class F> void onSites(const vector<site_id>& siteIDs, F&& f);
+    template <class F> auto onSite(site_id siteID, F&& f) -> decltype(f(declval<DataManager&>()));
+    bool canAdmit() const;
+    void admit();
+    void expire();
 
-    void abortTransaction(const tran_id tranID);
-    void commitTransaction(const tran_id tranID);
+    CommitResult finishEnd(const tran_id tranID, SerializationGraph::Verdict verdict);
+    AbortReason validate(const tran_id tranID, SerializationGraph::Verdict verdict);
+    CommitResult abortTransaction(const tran_id tranID, AbortReason reason);
+    CommitResult commitTransaction(const tran_id tranID);
+    void setStatus(Transaction& t, TranStatus status);
     vector<tran_id> getWAWConflict(const tran_id tranID);
+    const unordered_map<tran_id, Status>& getStatusList() const;
+    int getSyncReplicas() const;
+    bool isLagging(site_id siteID, var_id varID, double startTime) const;
+    void catchUp(site_id siteID, var_id varID);
+    void propagate();
 };
 
 #endif
\ No newline at end of file
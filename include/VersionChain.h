@@ -0,0 +1,107 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This header file defines the VersionChain class, which holds
+ *                the committed versions of one variable at one site, and the
+ *                Epoch class used to reclaim versions removed from a chain.
+ *
+ *                Key components include:
+ *                 - VersionChain: a singly linked list of versions, newest
+ *                   first, with a skip link per version so lookups deep in
+ *                   the history take O(log n) steps. Readers look up the
+ *                   version for their snapshot without taking any lock; one
+ *                   writer at a time (the thread committing to the site)
+ *                   inserts and truncates.
+ *                 - Epoch: epoch-based reclamation. A reader pins the current
+ *                   epoch while it walks a chain; a version unlinked by the
+ *                   writer is freed only once no reader pinned at or before
+ *                   the epoch it was unlinked in is still running.
+ ****************************************************************************/
+
+#ifndef VersionChain_H
+#define VersionChain_H
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include "common.h"
+
+class Epoch {
+public:
+    // pins the calling thread to the current epoch while it is alive, may nest
+    class Guard {
+    public:
+        Guard();
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    static void retire(void* node, void (*deleter)(void*));
+    static size_t reclaim();        // frees what no pinned reader can reach, returns the count
+    static size_t pending();        // retired, not yet freed
+
+private:
+    static constexpr size_t maxThreads = 256;
+    static constexpr uint64_t idle = numeric_limits<uint64_t>::max();
+
+    struct alignas(64) Slot {
+        atomic<uint64_t> epoch{ idle };     // pinned epoch, idle when not reading
+        atomic<bool> used{ false };
+    };
+    struct Retired {
+        void* node;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+    struct State {
+        atomic<uint64_t> global{ 0 };
+        Slot slots[maxThreads];
+        mutex lock;                 // writers only, readers never take it
+        vector<Retired> limbo;
+        ~State();
+    };
+    struct Participant {
+        Slot* slot = nullptr;
+        int depth = 0;
+        Participant();
+        ~Participant();
+    };
+
+    static State& state();
+    static Participant& participant();
+    static size_t reclaimLocked(State& s);
+};
+
+class VersionChain {
+public:
+    VersionChain() = default;
+    VersionChain(const VersionChain& other);
+    VersionChain& operator=(const VersionChain& other);
+    ~VersionChain();
+
+    void insert(double commitTime, int value);
+    pair<double, int> latestAt(double time) const;
+    size_t truncate(double before);
+    size_t size() const;
+
+private:
+    struct Version {
+        double commitTime;
+        int value;
+        size_t height;              // position from the oldest version when inserted
+        atomic<Version*> older;
+        atomic<Version*> skip;      // some older version, see skipHeight()
+    };
+
+    atomic<Version*> newest{ nullptr };
+    size_t count = 0;       // writer only
+
+    static void destroy(void* version);
+    static size_t skipHeight(size_t height);
+    static Version* ancestor(Version* from, size_t height);
+    void clear();
+    void copyFrom(const VersionChain& other);
+};
+
+#endif
@@ -1,7 +1,7 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-04-2024
- * Last Edited:   12-05-2024
+ * Last Edited:   10-19-2026
  * Description:   [Brief description of the functionality defined in this file.
  *                 For example, "This file declares the utility functions and
  *                 data structures used for processing transactions."]
@@ -20,6 +20,9 @@
 #include <stack>
 #include <algorithm>
 #include <regex>
+#include <bitset>
+#include <deque>
+#include <limits>
 
 using namespace std;
 
@@ -28,15 +31,47 @@ using namespace std;
 typedef int var_id;
 typedef int site_id;
 typedef int tran_id;
+typedef bitset<VAR_NUM + 1> var_set;     // bit i set <=> variable xi is in the set
 
-extern double globalTime;
+extern thread_local double globalTime;     // per thread, so shard workers can run on their own clock
 
 enum Status {
     commit,
     running
 };
 
+// one parsed line of the input language
+enum class CommandType {
+    None,
+    Begin,
+    Read,
+    Write,
+    End,
+    Fail,
+    Recover,
+    Dump,
+    QueryState,
+    Replication,
+    Lag,
+    ReadAt,
+    ReadBatch,
+    WriteBatch,
+    Admission,
+    AdmissionStats,
+    Contention
+};
+
+struct Command {
+    CommandType type = CommandType::None;
+    int id = 0;             // transaction id, site id for fail/recover, policy for replication, active limit, top-K for contention
+    var_id var = 0;         // variable, blocked limit for admission
+    int value = 0;          // written value, replication batch, queue limit for admission
+    double time = -1.0;     // readAt / dump(t) time, negative for now; blocked timeout for admission
+    vector<pair<var_id, int>> batch = {};   // RB / WB variables in input order, with WB values
+};
+
 double currentTime();
 vector<string> split(const string& line, char delimiter, int start);
+Command parseCommand(const string& inputs, string* error = nullptr);
 
 #endif
\ No newline at end of file
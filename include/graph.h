@@ -1,7 +1,7 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-03-2024
- * Last Edited:   12-07-2024
+ * Last Edited:   10-19-2026
  * Description:   This header file defines the structure and operations of the
  *                SerializationGraph class, which is used to model the dependency 
  *				  graph for transactions. 
@@ -19,11 +19,62 @@ public:
 		WW,
 		RW
 	};
+	// outcome of a batched cycle check
+	enum Verdict {
+		undecided,		// search with onCycle()
+		noCycle,
+		cycle
+	};
 	void addTran(const tran_id tranID);
 	void addDependency(const tran_id u, const tran_id v, EdgeType type);
 	void removeTran(const tran_id tranID);
 	bool hasCycle(const tran_id tranID, const unordered_map<tran_id, Status>& statusList) const;
+	bool onCycle(const tran_id tranID, const unordered_map<tran_id, Status>& statusList) const;
 	pair<unordered_map<tran_id, EdgeType>, unordered_map<tran_id, EdgeType>> getEdges(tran_id tranID) const;
+	vector<pair<tran_id, tran_id>> getPortalPaths(
+		const tran_id tranID,
+		const unordered_set<tran_id>& portals,
+		const unordered_map<tran_id, Status>& statusList
+	) const;
+
+	/*
+	 * Cycle checks for a batch of transactions validated one after another.
+	 * Reachability through the transactions committed before the batch is
+	 * memoized and shared by the whole batch; the candidates committed since
+	 * are followed through a small graph of the candidates.
+	 */
+	class BatchCheck {
+	public:
+		BatchCheck(const SerializationGraph& g, const vector<tran_id>& candidates, const unordered_map<tran_id, Status>& statusList);
+		Verdict verdict(const tran_id tranID);
+		void committed(const tran_id tranID);
+
+	private:
+		enum Kind { candidateNode, committedNode, otherNode };
+		enum State { fresh, open, done };
+		struct Slot {
+			Kind kind;
+			size_t index;		// candidate bit, or row of reach
+			State state;
+		};
+		struct Frame {
+			Slot* slot;
+			unordered_map<tran_id, EdgeType>::const_iterator next, end;
+		};
+
+		const SerializationGraph& g;
+		const unordered_map<tran_id, Status>& statusList;
+		size_t words;
+		unordered_map<tran_id, Slot> slots;
+		vector<uint64_t> reach;				// candidates each committed node leads to
+		vector<vector<uint64_t>> paths;		// candidates each candidate leads to
+		vector<bool> known;					// paths computed
+		vector<bool> ended;					// committed in the batch
+		vector<Frame> frames;
+
+		Slot& slotOf(const tran_id v);
+		int follow(const size_t i, const tran_id v);
+	};
 
 private:
 	unordered_map<tran_id, unordered_map<tran_id, EdgeType>> graph;
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This file implements the ContentionProfiler class, a
+ *                Space-Saving sketch of the variables behind conflicts and
+ *                aborts.
+ ****************************************************************************/
+
+#include "ContentionProfiler.h"
+
+ContentionProfiler::ContentionProfiler(size_t capacity) : capacity(max<size_t>(capacity, 1)) {
+    slots.reserve(this->capacity);
+}
+
+void ContentionProfiler::record(var_id varID, Event event) {
+    ++total;
+    size_t i;
+    auto it = position.find(varID);
+    if (it != position.end()) {
+        i = it->second;
+        ++slots[i].count;
+    }
+    else if (slots.size() < capacity) {
+        i = slots.size();
+        slots.push_back({ varID, 1, 0, 0, 0, 0, 0 });
+        place(i);
+        siftUp(i);
+        i = position[varID];
+    }
+    else {
+        // take over the least counted slot, inheriting its count as error
+        i = 0;
+        position.erase(slots[0].var);
+        size_t floor = slots[0].count;
+        slots[0] = { varID, floor + 1, floor, 0, 0, 0, 0 };
+        place(0);
+    }
+
+    HotVariable& hot = slots[i];
+    switch (event) {
+    case rwEdge:
+        ++hot.rwEdges;
+        break;
+    case wwEdge:
+        ++hot.wwEdges;
+        break;
+    case cycleAbort:
+        ++hot.cycleAborts;
+        break;
+    case firstCommitterAbort:
+        ++hot.firstCommitterAborts;
+        break;
+    }
+    siftDown(i);     // the count only grew
+}
+
+void ContentionProfiler::record(const var_set& vars, Event event) {
+    if (vars.none())
+        return;
+    for (var_id varID = 1; varID <= VAR_NUM; ++varID) {
+        if (vars.test(varID))
+            record(varID, event);
+    }
+}
+
+vector<HotVariable> ContentionProfiler::top(size_t k) const {
+    vector<HotVariable> hottest = slots;
+    k = min(k, hottest.size());
+    partial_sort(hottest.begin(), hottest.begin() + k, hottest.end(), hotter);
+    hottest.resize(k);
+    return hottest;
+}
+
+size_t ContentionProfiler::getTotal() const {
+    return total;
+}
+
+bool ContentionProfiler::hotter(const HotVariable& a, const HotVariable& b) {
+    if (a.count != b.count)
+        return a.count > b.count;
+    if (a.error != b.error)
+        return a.error < b.error;
+    return a.var < b.var;
+}
+
+void ContentionProfiler::place(size_t i) {
+    position[slots[i].var] = i;
+}
+
+void ContentionProfiler::siftUp(size_t i) {
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (slots[parent].count <= slots[i].count)
+            break;
+        swap(slots[parent], slots[i]);
+        place(parent);
+        place(i);
+        i = parent;
+    }
+}
+
+void ContentionProfiler::siftDown(size_t i) {
+    while (true) {
+        size_t least = i;
+        for (size_t child : { 2 * i + 1, 2 * i + 2 }) {
+            if (child < slots.size() && slots[child].count < slots[least].count)
+                least = child;
+        }
+        if (least == i)
+            break;
+        swap(slots[least], slots[i]);
+        place(least);
+        place(i);
+        i = least;
+    }
+}
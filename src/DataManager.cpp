@@ -1,7 +1,7 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-02-2024
- * Last Edited:   12-08-2024
+ * Last Edited:   10-19-2026
  * Description:   This file implements the DataManager class, which is responsible
  *                for managing site data in a distributed database system.
  *                It handles data storage, retrieval, and modifications
@@ -11,6 +11,11 @@
  *                 - Committing or aborting cached writes.
  *                 - Managing site availability and failure recovery.
  *                 - Maintaining a version history for each variable.
+ *
+ *                Snapshot reads (read, readBatch, readAt) may run on other
+ *                threads while one thread commits: version lookups are
+ *                lock-free, see VersionChain. Everything else, including
+ *                fail and recover, runs on the committing thread.
  ****************************************************************************/
 
 #include "DataManager.h"
@@ -25,7 +30,7 @@ DataManager::DataManager(site_id id) : siteID(id) {
 			Variable var;
 			var.lastCommitTime = 0.0;
 			var.value = i * 10;
-			var.versionHistory[0.0] = var.value;
+			var.versionHistory.insert(0.0, var.value);
 			variables[i] = var;
 		}
 		vector<var_id> list = { id - 1, id + 9 };
@@ -33,7 +38,7 @@ DataManager::DataManager(site_id id) : siteID(id) {
 			Variable var;
 			var.lastCommitTime = 0.0;
 			var.value = i * 10;
-			var.versionHistory[0.0] = var.value;
+			var.versionHistory.insert(0.0, var.value);
 			variables[i] = var;
 		}
 	}
@@ -42,74 +47,128 @@ DataManager::DataManager(site_id id) : siteID(id) {
 			Variable var;
 			var.lastCommitTime = 0.0;
 			var.value = i * 10;
-			var.versionHistory[0.0] = var.value;
+			var.versionHistory.insert(0.0, var.value);
 			variables[i] = var;
 		}
 	}
 }
 
 pair<bool, int> DataManager::read(const var_id varID, const double startTime) {
+	requests.fetch_add(1, memory_order_relaxed);
+	return readVersion(varID, startTime);
+}
+
+// several reads for one snapshot in a single request, results in input order
+vector<pair<bool, int>> DataManager::readBatch(const vector<var_id>& varIDs, const double startTime) {
+	requests.fetch_add(1, memory_order_relaxed);
+	vector<pair<bool, int>> results;
+	results.reserve(varIDs.size());
+	for (var_id varID : varIDs)
+		results.push_back(readVersion(varID, startTime));
+	return results;
+}
+
+pair<bool, int> DataManager::readVersion(const var_id varID, const double startTime) {
 	if (variables.find(varID) == variables.end())
 		return { false, -1 };	// not exsist
 
-	Variable& var = variables[varID];
+	const Variable& var = variables.find(varID)->second;
 
-	auto it = var.versionHistory.lower_bound(startTime);
-	if (it == var.versionHistory.begin() && it->first > startTime)
+	auto [commitTime, value] = var.versionHistory.latestAt(startTime);
+	if (commitTime < 0)
 		return { false, -1 };		// no suitable version
-	else if (it == var.versionHistory.end() || it->first > startTime)
-		--it;
 
-	if (it->first < status.failTime && startTime < status.failTime) {
+	// for replicated variable, a failure between the version and the snapshot
+	// may have missed later commits, must wait for a commit after fail
+	if (varID % 2 == 0 && !wasUp(commitTime, startTime))
+		return { false, -1 };
+
+	if (commitTime < status.failTime && startTime < status.failTime) {
 		if (status.available)
-			return { true, it->second };
+			return { true, value };
 		else
-			return { false, it->second };
+			return { false, value };
 	}
+	return { true, value };
+}
 
-	// for replicated variable, must wait for a commit after fail
-	if (varID % 2 == 0 && it->first < status.failTime)
-		return { false, -1 };
-	return { true, it->second };
+// latest version committed at or before time, as (commit time, value);
+// commit time is -1 when the site has no such version
+pair<double, int> DataManager::readAt(const var_id varID, const double time) const {
+	auto found = variables.find(varID);
+	if (found == variables.end())
+		return { -1.0, -1 };
+
+	return found->second.versionHistory.latestAt(time);
 }
 
-bool DataManager::write(const tran_id tranID, const var_id varID, const int value) {
-	if (!status.available) {
-		cout << "Write Failed, site not available!" << endl;
-		return false;
-	}
+// reclaim versions no snapshot at or after before can read; readAt and dump
+// at earlier times no longer find them. Returns the number of versions dropped.
+size_t DataManager::pruneVersions(const double before) {
+	size_t dropped = 0;
+	for (auto& [id, variable] : variables)
+		dropped += variable.versionHistory.truncate(before);
+	return dropped;
+}
 
-	if (!variables.count(varID)) {
-		cout << "Write Failed, variable not exist!" << endl;
-		return false;
+// whether the site stayed up during (from, to], so it saw every commit in between
+bool DataManager::wasUp(const double from, const double to) const {
+	for (const auto& [failTime, recoverTime] : downtime) {
+		if (failTime <= to && recoverTime > from)
+			return false;
 	}
+	return true;
+}
+
+bool DataManager::write(const tran_id tranID, const var_id varID, const int value) {
+	requests.fetch_add(1, memory_order_relaxed);
+	if (!status.available)
+		return false;	// site not available
+
+	if (!variables.count(varID))
+		return false;	// variable not exist
 
 	cacheWrites[tranID][varID] = value;
 	return true;
 }
 
-void DataManager::commitWrite(const tran_id tranID, const var_id varID, const int value) {
+// several writes of one transaction in a single request, results in input order
+vector<bool> DataManager::writeBatch(const tran_id tranID, const vector<pair<var_id, int>>& writes) {
+	requests.fetch_add(1, memory_order_relaxed);
+	vector<bool> results(writes.size(), false);
+	if (!status.available)
+		return results;	// site not available
+
+	for (size_t i = 0; i < writes.size(); ++i) {
+		auto [varID, value] = writes[i];
+		if (!variables.count(varID))
+			continue;	// variable not exist
+		cacheWrites[tranID][varID] = value;
+		results[i] = true;
+	}
+	return results;
+}
+
+bool DataManager::commitWrite(const tran_id tranID, const var_id varID, const int value) {
+	requests.fetch_add(1, memory_order_relaxed);
 	if (cacheWrites[tranID].empty())
-		return;
+		return false;
 	
-	if (!variables.count(varID)) {
-		cout << "Commit failed!" << endl;
-		return;
-	}
+	if (!variables.count(varID))
+		return false;	// commit failed
 	Variable& variable = variables[varID];
 	variable.lastCommitTime = currentTime();
 	variable.value = value;
-	variable.versionHistory[variable.lastCommitTime] = value;
+	variable.versionHistory.insert(variable.lastCommitTime, value);
 
 	cacheWrites[tranID].erase(varID);
 	if (cacheWrites[tranID].empty())
 		cacheWrites.erase(tranID);
-	//debug
-	cout << "T" << tranID << " writes x" << varID << " = " << value << " at site " << siteID << endl;
-	return;
+	return true;
 }
 
 void DataManager::abortWrite(const tran_id tranID) {
+	requests.fetch_add(1, memory_order_relaxed);
 	if (cacheWrites.find(tranID) == cacheWrites.end())
 		return;
 
@@ -118,6 +177,30 @@ void DataManager::abortWrite(const tran_id tranID) {
 	//cout << "T" << tranID << " aborted write for x" << var << " at site" << siteID << endl;
 }
 
+void DataManager::discardWrite(const tran_id tranID, const var_id varID) {
+	auto it = cacheWrites.find(tranID);
+	if (it == cacheWrites.end())
+		return;
+
+	it->second.erase(varID);
+	if (it->second.empty())
+		cacheWrites.erase(it);
+}
+
+// install a version committed earlier on another replica
+void DataManager::applyReplicated(const var_id varID, const int value, const double commitTime) {
+	requests.fetch_add(1, memory_order_relaxed);
+	if (!variables.count(varID))
+		return;
+
+	Variable& variable = variables[varID];
+	variable.versionHistory.insert(commitTime, value);
+	if (commitTime >= variable.lastCommitTime) {
+		variable.lastCommitTime = commitTime;
+		variable.value = value;
+	}
+}
+
 bool DataManager::isAvailable() const {
 	return status.available;
 }
@@ -139,6 +222,11 @@ unordered_map<var_id, DataManager::Variable>& DataManager::getVariables() {
 }
 
 void DataManager::setAvailable(bool flag) {
+	if (flag && !status.available && !downtime.empty())
+		downtime.back().second = currentTime();
+	if (!flag && status.available)
+		downtime.push_back({ currentTime(), numeric_limits<double>::infinity() });
+
 	status.available = flag;
 	if (!flag)
 		status.failTime = currentTime();
@@ -165,3 +253,8 @@ const std::unordered_map<tran_id, std::unordered_map<var_id, int>>& DataManager:
 	return cacheWrites;
 }
 
+
+
+size_t DataManager::getRequestCount() const {
+	return requests.load(memory_order_relaxed);
+}
@@ -0,0 +1,472 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This file implements the ShardCoordinator class, the
+ *                partitioned mode of the database. Each shard is a complete
+ *                TransactionManager (own sites, own serialization graph)
+ *                driven by a worker thread through a task queue.
+ *
+ *                Commit protocol:
+ *                 - A transaction living on one shard ends on that shard.
+ *                   If its graph reaches a distributed transaction in both
+ *                   directions, the coordinator also runs the global check.
+ *                 - A transaction living on several shards uses two-phase
+ *                   commit: every shard votes with prepareTransaction(), then
+ *                   the global check runs, then all shards commit or abort.
+ *                 - The global check collects, from every shard, the paths
+ *                   between distributed transactions (getPortalPaths) and
+ *                   looks for a cycle in the combined graph.
+ *
+ *                Every task reports into its own result segment; segments are
+ *                replayed to the sink in the order the commands were
+ *                received, so results do not depend on thread scheduling.
+ ****************************************************************************/
+
+#include "ShardCoordinator.h"
+
+ShardCoordinator::ShardCoordinator(int shardNum, ResultSink* sink) {
+    setSink(sink);
+    if (shardNum < 1)
+        shardNum = 1;
+    for (int i = 0; i < shardNum; ++i) {
+        shards.push_back(make_unique<Shard>());
+        shards.back()->worker = thread(&ShardCoordinator::run, this, shards.back().get());
+    }
+    for (site_id i = 0; i <= SITE_NUM; ++i)
+        siteAvailable[i] = true;
+}
+
+ShardCoordinator::~ShardCoordinator() {
+    flush();
+    for (auto& shard : shards) {
+        {
+            lock_guard<mutex> lk(shard->lock);
+            shard->stopping = true;
+        }
+        shard->ready.notify_one();
+        shard->worker.join();
+    }
+}
+
+void ShardCoordinator::setSink(ResultSink* s) {
+    static ResultSink silent;
+    sink = s ? s : &silent;
+}
+
+int ShardCoordinator::getShardNum() const {
+    return static_cast<int>(shards.size());
+}
+
+// each shard profiles only its own variables, so the top k overall is among
+// the top k of every shard
+vector<HotVariable> ShardCoordinator::hotVariables(size_t k) {
+    barrier();
+    vector<HotVariable> hottest;
+    for (const auto& shard : shards) {
+        vector<HotVariable> top = shard->manager.hotVariables(k);
+        hottest.insert(hottest.end(), top.begin(), top.end());
+    }
+    sort(hottest.begin(), hottest.end(), ContentionProfiler::hotter);
+    if (hottest.size() > k)
+        hottest.resize(k);
+    return hottest;
+}
+
+int ShardCoordinator::shardOf(var_id varID) const {
+    return varID % static_cast<int>(shards.size());
+}
+
+void ShardCoordinator::run(Shard* shard) {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lk(shard->lock);
+            shard->ready.wait(lk, [shard] { return shard->stopping || !shard->tasks.empty(); });
+            if (shard->tasks.empty())
+                return;
+            task = move(shard->tasks.front());
+            shard->tasks.pop_front();
+        }
+        task();
+        {
+            lock_guard<mutex> lk(shard->lock);
+            if (--shard->pending == 0)
+                shard->idle.notify_all();
+        }
+    }
+}
+
+void ShardCoordinator::enqueue(int shardID, function<void(ResultSink&)> task) {
+    auto segment = make_shared<Segment>();
+    segments.push_back(segment);
+    double time = currentTime();
+
+    Shard* shard = shards[shardID].get();
+    {
+        lock_guard<mutex> lk(shard->lock);
+        shard->tasks.push_back([shard, segment, time, task = move(task)] {
+            globalTime = time;
+            shard->manager.setSink(&segment->log);
+            task(segment->log);
+            shard->manager.setSink(nullptr);
+            segment->done = true;
+        });
+        ++shard->pending;
+    }
+    shard->ready.notify_one();
+}
+
+void ShardCoordinator::waitIdle(int shardID) {
+    Shard* shard = shards[shardID].get();
+    unique_lock<mutex> lk(shard->lock);
+    shard->idle.wait(lk, [shard] { return shard->pending == 0; });
+}
+
+void ShardCoordinator::barrier() {
+    for (int i = 0; i < getShardNum(); ++i)
+        waitIdle(i);
+}
+
+ResultSink& ShardCoordinator::note() {
+    auto segment = make_shared<Segment>();
+    segment->done = true;
+    segments.push_back(segment);
+    return segment->log;
+}
+
+void ShardCoordinator::emit() {
+    while (!segments.empty() && segments.front()->done) {
+        segments.front()->log.replay(*sink);
+        segments.pop_front();
+    }
+}
+
+void ShardCoordinator::flush() {
+    barrier();
+    emit();
+}
+
+void ShardCoordinator::inputHandle(const string& inputs) {
+    string error;
+    Command cmd = parseCommand(inputs, &error);
+    if (!error.empty())
+        note().onMessage(error);
+    execute(cmd);
+}
+
+void ShardCoordinator::execute(const Command& cmd) {
+    switch (cmd.type) {
+    case CommandType::Begin:
+        if (transList.count(cmd.id)) {
+            note().onMessage("Transaction " + to_string(cmd.id) + " already exists.");
+            break;
+        }
+        transList[cmd.id] = { currentTime(), {}, false };
+        break;
+    case CommandType::Read:
+    case CommandType::Write: {
+        if (!transList.count(cmd.id)) {
+            note().onMessage("Transaction " + to_string(cmd.id) + " does not exist.");
+            break;
+        }
+        int shardID = shardOf(cmd.var);
+        touch(cmd.id, shardID);
+        TransactionManager* manager = &shards[shardID]->manager;
+        if (cmd.type == CommandType::Read)
+            enqueue(shardID, [manager, cmd](ResultSink&) { manager->readTransaction(cmd.id, cmd.var); });
+        else
+            enqueue(shardID, [manager, cmd](ResultSink&) { manager->writeTransaction(cmd.id, cmd.var, cmd.value); });
+        break;
+    }
+    case CommandType::ReadBatch:
+    case CommandType::WriteBatch: {
+        if (!transList.count(cmd.id)) {
+            for (size_t i = 0; i < cmd.batch.size(); ++i)
+                note().onMessage("Transaction " + to_string(cmd.id) + " does not exist.");
+            break;
+        }
+        // consecutive variables of one shard go as one sub-batch, keeping results in input order
+        for (size_t begin = 0, end = 0; begin < cmd.batch.size(); begin = end) {
+            int shardID = shardOf(cmd.batch[begin].first);
+            while (end < cmd.batch.size() && shardOf(cmd.batch[end].first) == shardID)
+                ++end;
+            vector<pair<var_id, int>> part(cmd.batch.begin() + begin, cmd.batch.begin() + end);
+            touch(cmd.id, shardID);
+            TransactionManager* manager = &shards[shardID]->manager;
+            if (cmd.type == CommandType::WriteBatch) {
+                enqueue(shardID, [manager, cmd, part](ResultSink&) { manager->writeBatch(cmd.id, part); });
+                continue;
+            }
+            vector<var_id> vars;
+            for (const auto& [varID, value] : part)
+                vars.push_back(varID);
+            enqueue(shardID, [manager, cmd, vars](ResultSink&) { manager->readBatch(cmd.id, vars); });
+        }
+        break;
+    }
+    case CommandType::End:
+        endTransaction(cmd.id);
+        break;
+    case CommandType::Fail:
+        if (cmd.id < 1 || cmd.id > SITE_NUM) {
+            note().onMessage("Invalid site ID");
+            break;
+        }
+        if (!siteAvailable[cmd.id]) {
+            note().onMessage("Site" + to_string(cmd.id) + " is already failed");
+            break;
+        }
+        siteAvailable[cmd.id] = false;
+        for (int i = 0; i < getShardNum(); ++i) {
+            TransactionManager* manager = &shards[i]->manager;
+            enqueue(i, [manager, cmd](ResultSink&) { manager->fail(cmd.id); });
+        }
+        break;
+    case CommandType::Recover:
+        if (cmd.id < 1 || cmd.id > SITE_NUM) {
+            note().onMessage("Invalid site");
+            break;
+        }
+        siteAvailable[cmd.id] = true;
+        for (int i = 0; i < getShardNum(); ++i) {
+            TransactionManager* manager = &shards[i]->manager;
+            enqueue(i, [manager, cmd](ResultSink&) { manager->recover(cmd.id); });
+        }
+        break;
+    case CommandType::Dump:
+        dump(cmd.time);
+        break;
+    case CommandType::ReadAt: {
+        int shardID = shardOf(cmd.var);
+        TransactionManager* manager = &shards[shardID]->manager;
+        enqueue(shardID, [manager, cmd](ResultSink&) { manager->execute(cmd); });
+        break;
+    }
+    case CommandType::QueryState:
+    case CommandType::Replication:
+    case CommandType::Lag:
+        for (int i = 0; i < getShardNum(); ++i) {
+            TransactionManager* manager = &shards[i]->manager;
+            enqueue(i, [manager, cmd](ResultSink&) { manager->execute(cmd); });
+        }
+        break;
+    case CommandType::Admission:
+    case CommandType::AdmissionStats:
+        note().onMessage("Admission control is not supported in partitioned mode");
+        break;
+    case CommandType::Contention:
+        note().onContention(hotVariables(cmd.id > 0 ? cmd.id : ContentionProfiler::defaultTop));
+        break;
+    default:
+        break;
+    }
+    emit();
+}
+
+// begin the transaction on the shard with its original start time, and mark
+// it distributed on every shard it lives on once it spans more than one
+void ShardCoordinator::touch(tran_id tranID, int shardID) {
+    Transaction& t = transList[tranID];
+    if (find(t.shards.begin(), t.shards.end(), shardID) != t.shards.end())
+        return;
+
+    Shard* shard = shards[shardID].get();
+    double startTime = t.startTime;
+    enqueue(shardID, [shard, tranID, startTime](ResultSink&) { shard->manager.beginTransaction(tranID, startTime); });
+    t.shards.push_back(shardID);
+
+    if (t.shards.size() < 2)
+        return;
+    for (int id : t.shards) {
+        if (t.shards.size() > 2 && id != shardID)
+            continue;
+        Shard* target = shards[id].get();
+        enqueue(id, [target, tranID](ResultSink&) { target->distributed.insert(tranID); });
+    }
+}
+
+void ShardCoordinator::endTransaction(tran_id tranID) {
+    auto it = transList.find(tranID);
+    if (it == transList.end() || it->second.finished)
+        return;
+
+    if (it->second.shards.empty())
+        touch(tranID, 0);
+    if (it->second.shards.size() == 1)
+        endLocal(tranID, it->second.shards.front());
+    else
+        endDistributed(tranID);
+}
+
+void ShardCoordinator::endLocal(tran_id tranID, int shardID) {
+    auto result = make_shared<promise<EndResult>>();
+    future<EndResult> outcome = result->get_future();
+
+    Shard* shard = shards[shardID].get();
+    enqueue(shardID, [shard, tranID, result](ResultSink& log) {
+        TransactionManager& manager = shard->manager;
+        if (!manager.hasTransaction(tranID)) {
+            result->set_value(unknown);
+            return;
+        }
+        AbortReason reason = manager.prepareTransaction(tranID);
+        if (reason != AbortReason::none) {
+            manager.abortPrepared(tranID);
+            log.onCommit({ tranID, false, reason, {} });
+            result->set_value(localAbort);
+            return;
+        }
+
+        // a cycle can only leave this shard through a distributed transaction
+        unordered_set<tran_id> portals = shard->distributed;
+        portals.insert(tranID);
+        bool reaches = false, reached = false;
+        for (const auto& [u, v] : manager.getPortalPaths(tranID, portals)) {
+            if (u == tranID && v != tranID)
+                reaches = true;
+            if (v == tranID && u != tranID)
+                reached = true;
+        }
+        if (reaches && reached) {
+            result->set_value(needGlobal);
+            return;
+        }
+        log.onCommit({ tranID, true, AbortReason::none, manager.commitPrepared(tranID) });
+        result->set_value(localCommit);
+    });
+
+    switch (outcome.get()) {
+    case localCommit:
+        transList[tranID].finished = true;
+        break;
+    case needGlobal:
+        finish(tranID, crossShardCycle(tranID) ? AbortReason::cycle : AbortReason::none);
+        break;
+    default:
+        transList.erase(tranID);
+        break;
+    }
+}
+
+void ShardCoordinator::endDistributed(tran_id tranID) {
+    const vector<int> participants = transList[tranID].shards;
+
+    /**   phase one: collect votes   **/
+    vector<future<AbortReason>> votes;
+    for (int shardID : participants) {
+        auto vote = make_shared<promise<AbortReason>>();
+        votes.push_back(vote->get_future());
+        TransactionManager* manager = &shards[shardID]->manager;
+        enqueue(shardID, [manager, tranID, vote](ResultSink&) {
+            vote->set_value(manager->prepareTransaction(tranID));
+        });
+    }
+
+    AbortReason reason = AbortReason::none;
+    bool missing = false;
+    for (auto& vote : votes) {
+        AbortReason v = vote.get();
+        missing |= (v == AbortReason::unknown);
+        if (reason == AbortReason::none)
+            reason = v;
+    }
+
+    // a shard already aborted it and reported so, clean up silently
+    if (missing) {
+        for (int shardID : participants) {
+            TransactionManager* manager = &shards[shardID]->manager;
+            enqueue(shardID, [manager, tranID](ResultSink&) { manager->abortPrepared(tranID); });
+        }
+        transList.erase(tranID);
+        return;
+    }
+
+    /**   phase two: global check, then commit or abort everywhere   **/
+    if (reason == AbortReason::none && crossShardCycle(tranID))
+        reason = AbortReason::cycle;
+    finish(tranID, reason);
+}
+
+bool ShardCoordinator::crossShardCycle(tran_id tranID) {
+    barrier();     // shards are idle from here on, safe to inspect directly
+
+    SerializationGraph exchange;
+    exchange.addTran(tranID);
+
+    for (auto& shard : shards) {
+        unordered_set<tran_id> portals = shard->distributed;
+        portals.insert(tranID);
+        for (const auto& [u, v] : shard->manager.getPortalPaths(tranID, portals)) {
+            if (u == v)
+                continue;
+            exchange.addTran(u);
+            exchange.addTran(v);
+            exchange.addDependency(u, v, SerializationGraph::RW);
+        }
+    }
+    unordered_map<tran_id, Status> statusList;
+    for (tran_id id : committedDistributed)
+        statusList[id] = Status::commit;
+    statusList[tranID] = Status::running;
+
+    return exchange.hasCycle(tranID, statusList);
+}
+
+void ShardCoordinator::finish(tran_id tranID, AbortReason reason) {
+    Transaction& t = transList[tranID];
+    if (reason != AbortReason::none) {
+        for (int shardID : t.shards) {
+            TransactionManager* manager = &shards[shardID]->manager;
+            enqueue(shardID, [manager, tranID](ResultSink&) { manager->abortPrepared(tranID); });
+        }
+        note().onCommit({ tranID, false, reason, {} });
+        transList.erase(tranID);
+        return;
+    }
+
+    vector<future<vector<SiteWrite>>> applied;
+    for (int shardID : t.shards) {
+        auto writes = make_shared<promise<vector<SiteWrite>>>();
+        applied.push_back(writes->get_future());
+        TransactionManager* manager = &shards[shardID]->manager;
+        enqueue(shardID, [manager, tranID, writes](ResultSink&) { writes->set_value(manager->commitPrepared(tranID)); });
+    }
+    CommitResult result = { tranID, true, AbortReason::none, {} };
+    for (auto& writes : applied) {
+        vector<SiteWrite> w = writes.get();
+        result.writes.insert(result.writes.end(), w.begin(), w.end());
+    }
+    note().onCommit(result);
+
+    t.finished = true;
+    if (t.shards.size() > 1)
+        committedDistributed.insert(tranID);
+}
+
+// current values, or the values at time when it is not negative
+void ShardCoordinator::dump(double time) {
+    barrier();
+
+    vector<SiteSnapshot> snapshot;
+    for (site_id siteID = 1; siteID <= SITE_NUM; ++siteID) {
+        SiteSnapshot current = { siteID, {} };
+        for (int i = 0; i < getShardNum(); ++i) {
+            DataManager* site = shards[i]->manager.getSite(siteID);
+            for (const auto& [id, var] : site->getVariables()) {
+                if (shardOf(id) != i)
+                    continue;
+                if (time < 0) {
+                    current.values.emplace_back(id, var.value);
+                    continue;
+                }
+                auto [commitTime, value] = site->readAt(id, time);
+                if (commitTime >= 0)
+                    current.values.emplace_back(id, value);
+            }
+        }
+        sort(current.values.begin(), current.values.end());
+        snapshot.push_back(move(current));
+    }
+    note().onDump(snapshot);
+}
@@ -0,0 +1,248 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This file implements the Simulator class. Events are taken
+ *                from the queue in virtual time order; globalTime is set to
+ *                the event time before the TransactionManager runs it, so
+ *                snapshots and commit timestamps follow the virtual clock.
+ *
+ *                The network cost of a command is derived from the requests
+ *                each DataManager received while running it: a site that got
+ *                n requests costs n round trips on its link, and the command
+ *                returns when the slowest site has answered.
+ ****************************************************************************/
+
+#include "Simulator.h"
+#include "Trace.h"
+
+Simulator::Simulator(const Config& config) : config(config), rng(config.seed) {
+    manager.setAdmission(config.admission);
+}
+
+void Simulator::schedule(double time, EventKind kind, const Command& cmd) {
+    events.push({ time, seq++, kind, cmd });
+    if (kind == client || kind == global)
+        ++workload;
+}
+
+// begin lines start a client at their position in the trace, the rest of the
+// transaction follows its replies; other lines keep their trace position.
+// Binary traces give the position as a time, in ticks of one line each.
+void Simulator::load(istream& trace) {
+    if (TraceReader::isBinary(trace)) {
+        TraceReader reader(trace);
+        Command cmd;
+        double time;
+        while (reader.next(cmd, time))
+            add(cmd, time / reader.getTick() * config.arrival);
+    }
+    else {
+        string line;
+        double time = 0.0;
+        while (getline(trace, line)) {
+            add(parseCommand(line), time);
+            time += config.arrival;
+        }
+    }
+
+    if (config.mtbf > 0.0) {
+        for (site_id i = 1; i <= SITE_NUM; ++i)
+            scheduleFailure(i, 0.0);
+    }
+}
+
+void Simulator::add(const Command& cmd, double time) {
+    switch (cmd.type) {
+    case CommandType::None:
+        break;
+    case CommandType::Begin:
+        if (!clients.count(cmd.id)) {
+            clients[cmd.id] = {};
+            schedule(time, client, cmd);
+        }
+        break;
+    case CommandType::Read:
+    case CommandType::Write:
+    case CommandType::ReadBatch:
+    case CommandType::WriteBatch:
+    case CommandType::End:
+        if (clients.count(cmd.id))
+            clients[cmd.id].push_back(cmd);
+        break;
+    default:
+        schedule(time, global, cmd);
+        break;
+    }
+}
+
+void Simulator::scheduleFailure(site_id siteID, double after) {
+    exponential_distribution<double> gap(1.0 / config.mtbf);
+    Command cmd;
+    cmd.type = CommandType::Fail;
+    cmd.id = siteID;
+    schedule(after + gap(rng), failure, cmd);
+}
+
+// run one command and return how long the client waits for its reply
+double Simulator::execute(const Command& cmd) {
+    vector<size_t> before(SITE_NUM + 1);
+    for (site_id i = 1; i <= SITE_NUM; ++i)
+        before[i] = manager.getSite(i)->getRequestCount();
+
+    manager.execute(cmd);
+
+    uniform_real_distribution<double> noise(0.0, 1.0);
+    double delay = 0.0;
+    for (site_id i = 1; i <= SITE_NUM; ++i) {
+        size_t n = manager.getSite(i)->getRequestCount() - before[i];
+        if (n == 0)
+            continue;
+        metrics.requests += n;
+        const Link& link = config.links[i];
+        double cost = 0.0;
+        for (size_t k = 0; k < n; ++k)
+            cost += 2 * link.latency + 2 * config.requestSize / link.bandwidth + link.jitter * noise(rng);
+        delay = max(delay, cost);
+    }
+    return delay;
+}
+
+void Simulator::next(tran_id tranID, double time) {
+    deque<Command>& ops = clients[tranID];
+    if (ops.empty())
+        return;
+    schedule(time + config.think, client, ops.front());
+    ops.pop_front();
+}
+
+// wake up parked clients whose read was served after a recovery, that were
+// admitted, or whose transaction was aborted by the blocked timeout
+void Simulator::resume(double time) {
+    for (auto it = parked.begin(); it != parked.end();) {
+        TranStatus status = manager.getStatus(*it);
+        if (status == TranStatus::blocked || status == TranStatus::queued) {
+            ++it;
+            continue;
+        }
+        next(*it, time);
+        it = parked.erase(it);
+    }
+}
+
+void Simulator::run() {
+    double idleSince = 0.0;
+    while (!events.empty()) {
+        // only random failures left: stop, or give parked clients a few repairs
+        if (workload == 0) {
+            if (parked.empty() || config.mtbf <= 0.0)
+                break;
+            if (idleSince == 0.0)
+                idleSince = metrics.endTime;
+            if (events.top().time > idleSince + 10 * config.mttr)
+                break;
+        }
+
+        Event e = events.top();
+        events.pop();
+        globalTime = e.time;
+        metrics.endTime = max(metrics.endTime, e.time);
+
+        switch (e.kind) {
+        case global:
+            --workload;
+            execute(e.cmd);
+            if (e.cmd.type == CommandType::Fail)
+                ++metrics.failures;
+            break;
+        case failure: {
+            if (!manager.getSite(e.cmd.id)->isAvailable()) {
+                scheduleFailure(e.cmd.id, e.time);
+                break;
+            }
+            execute(e.cmd);
+            ++metrics.failures;
+            exponential_distribution<double> repair(1.0 / config.mttr);
+            Command cmd = e.cmd;
+            cmd.type = CommandType::Recover;
+            schedule(e.time + repair(rng), recovery, cmd);
+            break;
+        }
+        case recovery:
+            execute(e.cmd);
+            scheduleFailure(e.cmd.id, e.time);
+            break;
+        case client: {
+            --workload;
+            tran_id tranID = e.cmd.id;
+            if (e.cmd.type == CommandType::Begin)
+                beginTime[tranID] = e.time;
+
+            double done = e.time + execute(e.cmd);
+            metrics.endTime = max(metrics.endTime, done);
+            TranStatus status = manager.getStatus(tranID);
+            if (e.cmd.type == CommandType::End || status == TranStatus::aborted) {
+                if (status == TranStatus::committed) {
+                    ++metrics.commits;
+                    metrics.latencies.push_back(done - beginTime[tranID]);
+                }
+                else
+                    ++metrics.aborts;
+                clients[tranID].clear();
+                break;
+            }
+            if (status == TranStatus::blocked || status == TranStatus::queued) {
+                parked.insert(tranID);
+                break;
+            }
+            next(tranID, done);
+            break;
+        }
+        }
+        if (!parked.empty())
+            resume(e.time);
+    }
+    metrics.stuck = parked.size();
+}
+
+const Simulator::Metrics& Simulator::getMetrics() const {
+    return metrics;
+}
+
+void Simulator::report(ostream& os) const {
+    size_t finished = metrics.commits + metrics.aborts;
+    vector<double> sorted = metrics.latencies;
+    sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) {
+        if (sorted.empty())
+            return 0.0;
+        return sorted[min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+    };
+    double mean = 0.0;
+    for (double l : sorted)
+        mean += l;
+    if (!sorted.empty())
+        mean /= sorted.size();
+
+    os << "=== simulation" << endl;
+    os << "virtual time:   " << metrics.endTime << " ms" << endl;
+    os << "commits:        " << metrics.commits << endl;
+    os << "aborts:         " << metrics.aborts
+        << " (" << (finished ? 100.0 * metrics.aborts / finished : 0.0) << "%)" << endl;
+    os << "still blocked:  " << metrics.stuck << endl;
+    os << "site failures:  " << metrics.failures << endl;
+    os << "site requests:  " << metrics.requests << endl;
+    AdmissionStats admission = manager.admissionStats();
+    os << "rejected:       " << admission.rejected << endl;
+    os << "timed out:      " << admission.timedOut << endl;
+    os << "queue wait:     mean " << admission.meanQueueWait << " ms, max " << admission.maxQueueWait << " ms" << endl;
+    os << "hot variables: ";
+    vector<HotVariable> hot = manager.hotVariables(3);
+    if (hot.empty())
+        os << " none";
+    for (const HotVariable& h : hot)
+        os << " x" << h.var << " (" << h.count << ")";
+    os << endl;
+    os << "commit latency: mean " << mean << " ms, p50 " << percentile(0.5)
+        << " ms, p99 " << percentile(0.99) << " ms, max " << percentile(1.0) << " ms" << endl;
+}
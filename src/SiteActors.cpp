@@ -0,0 +1,199 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This file implements the SiteActors class: the request and
+ *                reply queues, the actor loop, and sleeping and waking on
+ *                either side.
+ ****************************************************************************/
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+#include "SiteActors.h"
+
+static size_t roundUp(size_t n) {
+    size_t p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+SiteActors::RequestQueue::RequestQueue(size_t capacity) : slots(roundUp(max<size_t>(1, capacity))) {
+    mask = slots.size() - 1;
+}
+
+bool SiteActors::RequestQueue::push(const Request& r) {
+    size_t t = tail.load(memory_order_relaxed);
+    if (t - head.load(memory_order_acquire) == slots.size())
+        return false;       // full
+    slots[t & mask] = r;
+    tail.store(t + 1, memory_order_release);
+    return true;
+}
+
+bool SiteActors::RequestQueue::pop(Request& r) {
+    size_t h = head.load(memory_order_relaxed);
+    if (h == tail.load(memory_order_acquire))
+        return false;
+    r = slots[h & mask];
+    head.store(h + 1, memory_order_release);
+    return true;
+}
+
+bool SiteActors::RequestQueue::empty() const {
+    return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
+}
+
+SiteActors::ReplyQueue::ReplyQueue(size_t capacity) {
+    size_t n = roundUp(max<size_t>(1, capacity));
+    cells.reset(new Cell[n]);
+    for (size_t i = 0; i < n; ++i)
+        cells[i].seq.store(i, memory_order_relaxed);
+    mask = n - 1;
+}
+
+// a cell is free for position pos when its sequence is pos, and holds the
+// reply of position pos once it is pos + 1
+bool SiteActors::ReplyQueue::push(size_t actor) {
+    size_t pos = tail.load(memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        size_t seq = cell->seq.load(memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;   // full
+        else
+            pos = tail.load(memory_order_relaxed);
+    }
+    cell->actor = actor;
+    cell->seq.store(pos + 1, memory_order_release);
+    return true;
+}
+
+bool SiteActors::ReplyQueue::pop(size_t& actor) {
+    Cell& cell = cells[head & mask];
+    if (cell.seq.load(memory_order_acquire) != head + 1)
+        return false;
+    actor = cell.actor;
+    cell.seq.store(head + mask + 1, memory_order_release);
+    ++head;
+    return true;
+}
+
+SiteActors::SiteActors(const vector<DataManager*>& sites, size_t capacity, bool pin)
+    : replies(sites.size() * max<size_t>(1, capacity)) {
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    for (DataManager* site : sites)
+        actors.push_back(make_unique<Actor>(site, capacity));
+    for (size_t i = 0; i < actors.size(); ++i) {
+        Actor& actor = *actors[i];
+        actor.worker = thread(&SiteActors::run, this, ref(actor), i);
+#ifdef __linux__
+        if (pin) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(i % cores, &set);
+            pthread_setaffinity_np(actor.worker.native_handle(), sizeof(set), &set);     // best effort
+        }
+#else
+        (void)pin;
+#endif
+    }
+}
+
+SiteActors::~SiteActors() {
+    stopping.store(true);
+    for (unique_ptr<Actor>& actor : actors) {
+        {
+            lock_guard<mutex> guard(actor->lock);
+        }
+        actor->wake.notify_one();
+        actor->worker.join();
+    }
+}
+
+size_t SiteActors::size() const {
+    return actors.size();
+}
+
+void SiteActors::post(size_t index, Task fn, void* arg) {
+    Actor& actor = *actors[index];
+    while (!actor.queue.push({ fn, arg, currentTime() }))
+        this_thread::yield();
+    // pairs with the fence in run(): either the actor sees the request or we see it asleep
+    atomic_thread_fence(memory_order_seq_cst);
+    if (actor.sleeping.load(memory_order_relaxed)) {
+        lock_guard<mutex> guard(actor.lock);
+        actor.wake.notify_one();
+    }
+}
+
+void SiteActors::gather(size_t count) {
+    size_t actor;
+    int idle = 0;
+    while (count > 0) {
+        if (replies.pop(actor)) {
+            --count;
+            idle = 0;
+            continue;
+        }
+        if (idle++ < spins) {
+            this_thread::yield();
+            continue;
+        }
+        this_thread::yield();
+        callerSleeping.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (replies.pop(actor)) {
+            callerSleeping.store(false, memory_order_relaxed);
+            --count;
+            continue;
+        }
+        unique_lock<mutex> guard(callerLock);
+        callerWake.wait(guard, [this, &actor] { return replies.pop(actor); });
+        callerSleeping.store(false, memory_order_relaxed);
+        --count;
+    }
+}
+
+void SiteActors::run(Actor& actor, size_t index) {
+    Request r;
+    int idle = 0;
+    for (;;) {
+        if (actor.queue.pop(r)) {
+            globalTime = r.time;
+            r.fn(*actor.site, r.arg);
+            while (!replies.push(index))
+                this_thread::yield();
+            atomic_thread_fence(memory_order_seq_cst);
+            if (callerSleeping.load(memory_order_relaxed)) {
+                lock_guard<mutex> guard(callerLock);
+                callerWake.notify_one();
+            }
+            idle = 0;
+            continue;
+        }
+        if (idle++ < spins) {
+            this_thread::yield();
+            continue;
+        }
+        actor.sleeping.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!actor.queue.empty()) {
+            actor.sleeping.store(false, memory_order_relaxed);
+            continue;
+        }
+        unique_lock<mutex> guard(actor.lock);
+        actor.wake.wait(guard, [&actor, this] { return !actor.queue.empty() || stopping.load(); });
+        actor.sleeping.store(false, memory_order_relaxed);
+        if (actor.queue.empty())
+            return;     // stopping, every request has been answered
+        idle = 0;
+    }
+}
@@ -0,0 +1,209 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This file implements the SnapshotExport class: parallel
+ *                workers encode runs of sites at the snapshot time, and a
+ *                writer streams the encoded runs in order.
+ ****************************************************************************/
+
+#include <cstring>
+#include <sstream>
+#include "SnapshotExport.h"
+#include "TextPrinter.h"
+
+static const char exportMagic[4] = { 'R', 'C', 'S', '1' };
+
+static void putVarint(string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+static void putDouble(string& out, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    for (int i = 0; i < 8; ++i)
+        out.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+}
+
+static bool getVarint(istream& in, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = in.get();
+        if (c == EOF)
+            return false;
+        v |= static_cast<uint64_t>(c & 0x7f) << shift;
+        if (!(c & 0x80))
+            return true;
+    }
+    return false;
+}
+
+SnapshotExport::SnapshotExport(const vector<DataManager*>& sites, double time, ostream& out, ExportFormat format, size_t threads)
+    : sites(sites), time(time), out(out), format(format) {
+    if (threads == 0)
+        threads = max(1u, thread::hardware_concurrency());
+    threads = max<size_t>(1, min(threads, sites.size()));
+    // a few runs per worker keep them balanced, longer runs cost fewer handoffs
+    chunk = max<size_t>(1, sites.size() / (8 * threads));
+    window = 4 * threads;
+    size_t runs = (sites.size() + chunk - 1) / chunk;
+    blocks.resize(runs);
+    ready.resize(runs);
+    started = chrono::steady_clock::now();
+
+    writer = thread(&SnapshotExport::writeAll, this);
+    for (size_t i = 0; i < threads; ++i)
+        workers.emplace_back(&SnapshotExport::work, this);
+}
+
+SnapshotExport::~SnapshotExport() {
+    wait();
+}
+
+SnapshotExport::Stats SnapshotExport::wait() {
+    if (done)
+        return stats;
+    for (thread& worker : workers)
+        worker.join();
+    writer.join();
+    out.flush();
+    done = true;
+    stats = { sites.size(), values, bytes, workers.size(),
+        chrono::duration<double>(chrono::steady_clock::now() - started).count() };
+    return stats;
+}
+
+double SnapshotExport::getTime() const {
+    return time;
+}
+
+void SnapshotExport::work() {
+    vector<SiteSnapshot> run;
+    ostringstream text;
+    TextPrinter printer(text);
+    while (true) {
+        size_t i;
+        {
+            unique_lock<mutex> guard(lock);
+            if (nextRun >= blocks.size())
+                return;
+            i = nextRun++;
+            changed.wait(guard, [&] { return i < written + window; });
+        }
+        run.clear();
+        size_t count = 0;
+        for (size_t s = i * chunk; s < min(sites.size(), (i + 1) * chunk); ++s) {
+            run.push_back(snapshotOf(sites[s]));
+            count += run.back().values.size();
+        }
+        string block;
+        if (format == ExportFormat::text) {
+            text.str("");
+            printer.onDump(run);
+            block = text.str();
+        }
+        else {
+            for (const SiteSnapshot& site : run)
+                encode(site, block);
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            values += count;
+            blocks[i] = move(block);
+            ready[i] = true;
+        }
+        changed.notify_all();
+    }
+}
+
+void SnapshotExport::writeAll() {
+    if (format == ExportFormat::binary) {
+        string header(exportMagic, sizeof(exportMagic));
+        putDouble(header, time);
+        putVarint(header, sites.size());
+        out.write(header.data(), header.size());
+        bytes += header.size();
+    }
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        string block;
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [&] { return ready[i]; });
+            block.swap(blocks[i]);
+        }
+        out.write(block.data(), block.size());
+        {
+            lock_guard<mutex> guard(lock);
+            bytes += block.size();
+            written = i + 1;
+        }
+        changed.notify_all();
+    }
+}
+
+// the site's variables as its own version store had them at time, as dump(t)
+SiteSnapshot SnapshotExport::snapshotOf(DataManager* site) const {
+    SiteSnapshot snapshot = { site->getSiteID(), {} };
+    for (const auto& [id, var] : site->getVariables()) {
+        auto [commitTime, value] = site->readAt(id, time);
+        if (commitTime >= 0)
+            snapshot.values.emplace_back(id, value);
+    }
+    sort(snapshot.values.begin(), snapshot.values.end());
+    return snapshot;
+}
+
+// appends the binary block of one site, see the layout in SnapshotExport.h
+void SnapshotExport::encode(const SiteSnapshot& site, string& block) const {
+    putVarint(block, site.site);
+    putVarint(block, site.values.size());
+    var_id previous = 0;
+    for (const auto& [id, value] : site.values) {
+        putVarint(block, id - previous);
+        previous = id;
+    }
+    for (const auto& [id, value] : site.values)
+        putVarint(block, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63));
+}
+
+bool SnapshotExport::read(istream& in, double& time, vector<SiteSnapshot>& snapshot) {
+    char magic[sizeof(exportMagic)];
+    unsigned char raw[8];
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, exportMagic, sizeof(magic)) != 0)
+        return false;
+    if (!in.read(reinterpret_cast<char*>(raw), sizeof(raw)))
+        return false;
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i)
+        bits |= static_cast<uint64_t>(raw[i]) << (8 * i);
+    memcpy(&time, &bits, sizeof(time));
+
+    uint64_t count;
+    if (!getVarint(in, count))
+        return false;
+    snapshot.clear();
+    for (uint64_t s = 0; s < count; ++s) {
+        uint64_t siteID, n, v;
+        if (!getVarint(in, siteID) || !getVarint(in, n))
+            return false;
+        SiteSnapshot site = { static_cast<site_id>(siteID), vector<pair<var_id, int>>(n) };
+        var_id id = 0;
+        for (auto& entry : site.values) {
+            if (!getVarint(in, v))
+                return false;
+            id += static_cast<var_id>(v);
+            entry.first = id;
+        }
+        for (auto& entry : site.values) {
+            if (!getVarint(in, v))
+                return false;
+            entry.second = static_cast<int>(static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1));
+        }
+        snapshot.push_back(move(site));
+    }
+    return true;
+}
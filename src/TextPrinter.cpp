@@ -0,0 +1,95 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This file implements the TextPrinter class, which formats
+ *                engine results as the text output of the command line
+ *                program.
+ ****************************************************************************/
+
+#include "TextPrinter.h"
+
+TextPrinter::TextPrinter(ostream& out) : out(out) {
+}
+
+void TextPrinter::onRead(const ReadResult& r) {
+    switch (r.status) {
+    case ReadStatus::ok:
+        if (r.resumed)
+            out << "T" << r.tranID << " unblocked" << endl;
+        out << "x" << r.var << ": " << r.value << endl;
+        break;
+    case ReadStatus::blocked:
+        for (site_id id : r.waitSites)
+            out << "T" << r.tranID << " waits for site " << id << endl;
+        break;
+    default:    // aborts are reported by onCommit
+        break;
+    }
+}
+
+void TextPrinter::onWrite(const WriteResult& r) {
+    if (r.sites.empty())
+        out << "Write Failed" << endl;
+}
+
+void TextPrinter::onCommit(const CommitResult& r) {
+    for (const SiteWrite& w : r.writes)
+        out << "T" << r.tranID << " writes x" << w.var << " = " << w.value << " at site " << w.site << endl;
+    out << "T" << r.tranID << (r.committed ? " commits" : " aborts") << endl;
+    out << endl;
+}
+
+void TextPrinter::onHistory(const HistoryRead& r) {
+    out << "x" << r.var << " at " << r.time << ": ";
+    if (r.found)
+        out << r.value << " (site " << r.site << ")" << endl;
+    else
+        out << "unavailable" << endl;
+}
+
+void TextPrinter::onDump(const vector<SiteSnapshot>& sites) {
+    for (const SiteSnapshot& site : sites) {
+        out << "site " << site.site << " - ";
+        if (site.values.empty()) {
+            out << "\n";
+            continue;
+        }
+        for (const auto& [id, val] : site.values) {
+            out << "x" << id << ": " << val << ", ";
+        }
+        out << endl;
+    }
+}
+
+void TextPrinter::onLag(const vector<ReplicaStats>& stats) {
+    for (const ReplicaStats& s : stats) {
+        out << "site " << s.site << " - pending: " << s.pending
+            << ", applied: " << s.applied
+            << ", lag: " << s.lag
+            << ", max lag: " << s.maxLag << endl;
+    }
+}
+
+void TextPrinter::onAdmission(const AdmissionStats& s) {
+    out << "active: " << s.active << ", blocked: " << s.blocked << ", queued: " << s.queued << endl;
+    out << "admitted: " << s.admitted << ", rejected: " << s.rejected << ", timed out: " << s.timedOut << endl;
+    out << "queue wait: mean " << s.meanQueueWait << ", max " << s.maxQueueWait << endl;
+}
+
+void TextPrinter::onContention(const vector<HotVariable>& hot) {
+    if (hot.empty())
+        out << "no contention" << endl;
+    for (const HotVariable& h : hot) {
+        out << "x" << h.var << " - events: " << h.count;
+        if (h.error > 0)
+            out << " (error " << h.error << ")";
+        out << ", rw: " << h.rwEdges << ", ww: " << h.wwEdges
+            << ", cycle aborts: " << h.cycleAborts
+            << ", first-committer aborts: " << h.firstCommitterAborts << endl;
+    }
+}
+
+void TextPrinter::onMessage(const string& message) {
+    out << message << endl;
+}
@@ -0,0 +1,269 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This file implements the binary trace format: encoding
+ *                Commands with TraceWriter, converting text traces, and
+ *                decoding them back with TraceReader.
+ ****************************************************************************/
+
+#include <cstring>
+#include "Trace.h"
+
+static const char traceMagic[4] = { 'R', 'C', 'T', '1' };
+static const int maxTicks = 64;     // longer gaps are written as raw times
+
+/**   TraceWriter   **/
+
+TraceWriter::TraceWriter(ostream& out, double tick) : out(out), tick(tick) {
+    out.write(traceMagic, sizeof(traceMagic));
+    putDouble(tick);
+}
+
+size_t TraceWriter::getCount() const {
+    return count;
+}
+
+void TraceWriter::putVarint(uint64_t v) {
+    while (v >= 0x80) {
+        out.put(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.put(static_cast<char>(v));
+}
+
+void TraceWriter::putSigned(int64_t v) {
+    putVarint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+}
+
+void TraceWriter::putDouble(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    for (int i = 0; i < 8; ++i)
+        out.put(static_cast<char>((bits >> (8 * i)) & 0xff));
+}
+
+void TraceWriter::write(const Command& cmd, double time) {
+    out.put(static_cast<char>(cmd.type));
+
+    // time as a whole number of ticks after the previous record when it is one
+    double t = last;
+    int ticks = 0;
+    while (t < time && ticks < maxTicks) {
+        t += tick;
+        ++ticks;
+    }
+    if (t == time)
+        putVarint(2 * ticks);
+    else {
+        putVarint(1);
+        putDouble(time);
+    }
+    last = time;
+
+    switch (cmd.type) {
+    case CommandType::Begin:
+    case CommandType::End:
+    case CommandType::Fail:
+    case CommandType::Recover:
+        putVarint(cmd.id);
+        break;
+    case CommandType::Read:
+        putVarint(cmd.id);
+        putVarint(cmd.var);
+        break;
+    case CommandType::Write:
+        putVarint(cmd.id);
+        putVarint(cmd.var);
+        putSigned(cmd.value);
+        break;
+    case CommandType::ReadBatch:
+    case CommandType::WriteBatch:
+        putVarint(cmd.id);
+        putVarint(cmd.batch.size());
+        for (const auto& [varID, value] : cmd.batch) {
+            putVarint(varID);
+            if (cmd.type == CommandType::WriteBatch)
+                putSigned(value);
+        }
+        break;
+    case CommandType::Dump:
+        putDouble(cmd.time);
+        break;
+    case CommandType::ReadAt:
+        putVarint(cmd.var);
+        putDouble(cmd.time);
+        break;
+    case CommandType::Replication:
+        putVarint(cmd.id);
+        putSigned(cmd.value);
+        break;
+    case CommandType::Admission:
+        putVarint(cmd.id);
+        putVarint(cmd.var);
+        putDouble(cmd.time);
+        putSigned(cmd.value);
+        break;
+    case CommandType::Contention:
+        putVarint(cmd.id);
+        break;
+    default:    // queryState, lag, admission stats: no operands
+        break;
+    }
+    ++count;
+}
+
+size_t TraceWriter::convert(istream& text, ostream& out, vector<string>* errors) {
+    TraceWriter writer(out);
+    string line;
+    double time = 0.0;
+    while (getline(text, line)) {
+        string error;
+        Command cmd = parseCommand(line, &error);
+        if (!error.empty() && errors)
+            errors->push_back(error);
+        if (error.empty() && cmd.type != CommandType::None)
+            writer.write(cmd, time);
+        time += writer.tick;
+    }
+    return writer.getCount();
+}
+
+/**   TraceReader   **/
+
+TraceReader::TraceReader(istream& in) : in(in) {
+    char magic[sizeof(traceMagic)];
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, traceMagic, sizeof(magic)) != 0)
+        return;
+    valid = getDouble(tick) && tick > 0.0;
+}
+
+bool TraceReader::isValid() const {
+    return valid;
+}
+
+double TraceReader::getTick() const {
+    return tick;
+}
+
+bool TraceReader::isBinary(istream& in) {
+    char magic[sizeof(traceMagic)];
+    streampos start = in.tellg();
+    bool binary = in.read(magic, sizeof(magic)) && memcmp(magic, traceMagic, sizeof(magic)) == 0;
+    in.clear();
+    in.seekg(start);
+    return binary;
+}
+
+bool TraceReader::getVarint(uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = in.get();
+        if (c == EOF)
+            return false;
+        v |= static_cast<uint64_t>(c & 0x7f) << shift;
+        if (!(c & 0x80))
+            return true;
+    }
+    return false;   // longer than any varint the writer produces
+}
+
+bool TraceReader::getInt(int& v) {
+    uint64_t raw;
+    if (!getVarint(raw))
+        return false;
+    v = static_cast<int>(raw);
+    return true;
+}
+
+bool TraceReader::getSigned(int& v) {
+    uint64_t raw;
+    if (!getVarint(raw))
+        return false;
+    v = static_cast<int>(static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1));
+    return true;
+}
+
+bool TraceReader::getDouble(double& v) {
+    unsigned char bytes[8];
+    if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+        return false;
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i)
+        bits |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    memcpy(&v, &bits, sizeof(v));
+    return true;
+}
+
+bool TraceReader::next(Command& cmd, double& time) {
+    if (!valid)
+        return false;
+    int op = in.get();
+    if (op == EOF)
+        return false;
+
+    cmd = Command();
+    cmd.type = static_cast<CommandType>(op);
+    uint64_t n;
+    if (!getVarint(n))
+        return false;
+    if (n & 1) {
+        if (!getDouble(last))
+            return false;
+    }
+    else {
+        for (uint64_t k = 0; k < n / 2; ++k)
+            last += tick;
+    }
+    time = last;
+
+    bool ok = true;
+    switch (cmd.type) {
+    case CommandType::Begin:
+    case CommandType::End:
+    case CommandType::Fail:
+    case CommandType::Recover:
+        ok = getInt(cmd.id);
+        break;
+    case CommandType::Read:
+        ok = getInt(cmd.id) && getInt(cmd.var);
+        break;
+    case CommandType::Write:
+        ok = getInt(cmd.id) && getInt(cmd.var) && getSigned(cmd.value);
+        break;
+    case CommandType::ReadBatch:
+    case CommandType::WriteBatch: {
+        int size = 0;
+        ok = getInt(cmd.id) && getInt(size);
+        for (int i = 0; ok && i < size; ++i) {
+            int varID = 0, value = 0;
+            ok = getInt(varID) && (cmd.type == CommandType::ReadBatch || getSigned(value));
+            cmd.batch.emplace_back(varID, value);
+        }
+        break;
+    }
+    case CommandType::Dump:
+        ok = getDouble(cmd.time);
+        break;
+    case CommandType::ReadAt:
+        ok = getInt(cmd.var) && getDouble(cmd.time);
+        break;
+    case CommandType::Replication:
+        ok = getInt(cmd.id) && getSigned(cmd.value);
+        break;
+    case CommandType::Admission:
+        ok = getInt(cmd.id) && getInt(cmd.var) && getDouble(cmd.time) && getSigned(cmd.value);
+        break;
+    case CommandType::Contention:
+        ok = getInt(cmd.id);
+        break;
+    case CommandType::QueryState:
+    case CommandType::Lag:
+    case CommandType::AdmissionStats:
+        break;
+    default:
+        ok = false;     // unknown opcode
+        break;
+    }
+    return ok;
+}
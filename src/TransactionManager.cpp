@@ -1,7 +1,7 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-02-2024
- * Last Edited:   12-08-2024
+ * Last Edited:   10-19-2026
  * Description:   This file implements the TransactionManager class, which is 
  *                the central component of the project. It handles input 
  *                commands and orchestrates all transactional operations 
@@ -9,7 +9,8 @@
  *                 - Starting and ending transactions (begin, end).
  *                 - Reading and writing variables (read, write).
  *                 - Managing site failures and recoveries (fail, recover).
- *                 - Querying and dumping the state of the system (dump, queryState).
+ *                 - Querying, dumping and exporting the state of the system
+ *                   (dump, exportSnapshot, queryState).
  * 
  *                The TransactionManager is responsible for coordinating with 
  *                the DataManager and SerializationGraph classes. It manages 
@@ -18,12 +19,18 @@
  * 
  *                Note: DataManager and SerializationGraph cannot invoke 
  *                TransactionManager functions. Information flow is unidirectional.
+ *                Every request that changes a site goes through onSite or
+ *                onSites, which call it directly or hand it to the site's
+ *                actor (setSiteActors). Fan-outs are planned first and their
+ *                replies are combined in site order afterwards, so both ways
+ *                report the same results.
  ****************************************************************************/
 
 #include "TransactionManager.h"
 #include "common.h"
 
 TransactionManager::TransactionManager() {
+    setSink(nullptr);
     sites.push_back({});
     for (site_id i = 1; i <= SITE_NUM; ++i) {
         DataManager* dm = new DataManager(i);
@@ -31,104 +38,211 @@ TransactionManager::TransactionManager() {
     }
 }
 
+TransactionManager::~TransactionManager() {
+    actors.reset();     // stop the actor threads before their sites go away
+    for (DataManager* site : sites)
+        delete site;
+}
+
+void TransactionManager::setSiteActors(bool on) {
+    if (!on)
+        actors.reset();
+    else if (!actors)
+        actors = make_unique<SiteActors>(vector<DataManager*>(sites.begin() + 1, sites.end()));
+}
+
+// f(site) for each listed site, at the same time when the sites run on actors
+template <class F>
+void TransactionManager::onSites(const vector<site_id>& siteIDs, F&& f) {
+    if (!actors) {
+        for (site_id siteID : siteIDs)
+            f(*sites[siteID]);
+        return;
+    }
+    vector<size_t> which;
+    for (site_id siteID : siteIDs)
+        which.push_back(siteID - 1);
+    actors->forEach(which, f);
+}
+
+template <class F>
+auto TransactionManager::onSite(site_id siteID, F&& f) -> decltype(f(declval<DataManager&>())) {
+    if (!actors)
+        return f(*sites[siteID]);
+    return actors->call(siteID - 1, f);
+}
+
+void TransactionManager::setSink(ResultSink* s) {
+    static ResultSink silent;
+    sink = s ? s : &silent;
+}
+
 void TransactionManager::inputHandle(const string& inputs) {
-    if (inputs.find("begin") == 0) {
-        vector<string> str = split(inputs, ',', 5);
-        if (str.size() != 1)
-            cout << "Invalid input command: " << inputs << endl;
-
-        int tranID = stoi(str[0].substr(1));
-        beginTransaction(tranID);
-    }
-    else if (inputs.find("R") != string::npos) {
-        vector<string> str = split(inputs, ',', 1);
-        if (str.size() != 2)
-            cout << "Invalid input command: " << inputs << endl;
-
-        int tranID = stoi(str[0].substr(1));
-        var_id varID = stoi(str[1].substr(1));
-        readTransaction(tranID, varID);
-    }
-    else if (inputs.find("W") != string::npos) {
-        vector<string> str = split(inputs, ',', 1);
-        if (str.size() != 3)
-            cout << "Invalid input command: " << inputs << endl;
-
-        int tranID = stoi(str[0].substr(1));
-        var_id varID = stoi(str[1].substr(1));
-        int value = stoi(str[2]);
-        writeTransaction(tranID, varID, value);
-    }
-    else if (inputs.find("end") == 0) {
-        vector<string> str = split(inputs, ',', 3);
-        if (str.size() != 1)
-            cout << "Invalid input command: " << inputs << endl;
-
-        int tranID = stoi(str[0].substr(1));
-        endTransaction(tranID);
-    }
-    else if (inputs.find("fail") == 0) {
-        vector<string> str = split(inputs, ',', 4);
-        if (str.size() != 1)
-            cout << "Invalid input command: " << inputs << endl;
-
-        int siteID = stoi(str[0]);
-        fail(siteID);
-    }
-    else if (inputs.find("recover") == 0) {
-        vector<string> str = split(inputs, ',', 7);
-        if (str.size() != 1)
-            cout << "Invalid input command: " << inputs << endl;
-
-        int siteID = stoi(str[0]);
-        recover(siteID);
-    }
-    else if (inputs.find("dump") == 0)
-        dump();
-    else if (inputs.find("queryState") == 0)
-        queryState();
-    else
+    string error;
+    Command cmd = parseCommand(inputs, &error);
+    if (!error.empty()) {
+        flush();    // keep the message after the results of earlier lines
+        sink->onMessage(error);
+    }
+    execute(cmd);
+}
+
+void TransactionManager::execute(const Command& cmd) {
+    // an end joins the batch unless it must wait for admission
+    if (cmd.type == CommandType::End && commitBatch > 1 && admissionQueue.empty()) {
+        pendingEnds.push_back({ cmd.id, currentTime() });
+        if (pendingEnds.size() >= commitBatch)
+            flush();
         return;
+    }
+    flush();
+
+    bool transactional = cmd.type == CommandType::Read || cmd.type == CommandType::Write
+        || cmd.type == CommandType::ReadBatch || cmd.type == CommandType::WriteBatch
+        || cmd.type == CommandType::End;
+    auto held = heldCommands.find(cmd.id);
+    if (transactional && held != heldCommands.end())
+        held->second.push_back(cmd);    // replayed once the transaction is admitted
+    else
+        dispatch(cmd);
+
+    expire();
+    admit();
+    propagate();
+}
+
+void TransactionManager::dispatch(const Command& cmd) {
+    switch (cmd.type) {
+    case CommandType::Begin:
+        beginTransaction(cmd.id);
+        break;
+    case CommandType::Read:
+        readTransaction(cmd.id, cmd.var);
+        break;
+    case CommandType::Write:
+        writeTransaction(cmd.id, cmd.var, cmd.value);
+        break;
+    case CommandType::ReadBatch: {
+        vector<var_id> vars;
+        for (const auto& [varID, value] : cmd.batch)
+            vars.push_back(varID);
+        readBatch(cmd.id, vars);
+        break;
+    }
+    case CommandType::WriteBatch:
+        writeBatch(cmd.id, cmd.batch);
+        break;
+    case CommandType::End:
+        endTransaction(cmd.id);
+        break;
+    case CommandType::Fail:
+        fail(cmd.id);
+        break;
+    case CommandType::Recover:
+        recover(cmd.id);
+        break;
+    case CommandType::Dump:
+        if (cmd.time < 0)
+            dump();
+        else
+            dumpAt(cmd.time);
+        break;
+    case CommandType::ReadAt:
+        readAt(cmd.var, cmd.time);
+        break;
+    case CommandType::QueryState:
+        queryState();
+        break;
+    case CommandType::Replication:
+        setReplicationPolicy(static_cast<ReplicationPolicy>(cmd.id), cmd.value);
+        break;
+    case CommandType::Lag:
+        replicationLag();
+        break;
+    case CommandType::Admission:
+        setAdmission({ static_cast<size_t>(max(cmd.id, 0)), static_cast<size_t>(max(cmd.var, 0)), cmd.time, cmd.value });
+        break;
+    case CommandType::AdmissionStats:
+        sink->onAdmission(admissionStats());
+        break;
+    case CommandType::Contention:
+        sink->onContention(hotVariables(cmd.id > 0 ? cmd.id : ContentionProfiler::defaultTop));
+        break;
+    default:
+        break;
+    }
 }
 
 
 
+// begin requested by a client, subject to admission control
 void TransactionManager::beginTransaction(tran_id tranID) {
+    if (transList.count(tranID) || heldCommands.count(tranID)) {
+        sink->onMessage("Transaction " + to_string(tranID) + " already exists.");
+        return;
+    }
+    if (admissionQueue.empty() && canAdmit()) {
+        ++admitStats.admitted;
+        beginTransaction(tranID, currentTime());
+        return;
+    }
+    if (admission.maxQueued >= 0 && admissionQueue.size() >= static_cast<size_t>(admission.maxQueued)) {
+        ++admitStats.rejected;
+        sink->onMessage("T" + to_string(tranID) + " rejected");
+        return;
+    }
+    admissionQueue.push_back({ tranID, currentTime() });
+    heldCommands[tranID];
+    sink->onMessage("T" + to_string(tranID) + " queued");
+}
+
+void TransactionManager::beginTransaction(tran_id tranID, double startTime) {
     if (transList.count(tranID)) {
-        cout << "Transaction " << tranID << " already exists." << endl;
+        sink->onMessage("Transaction " + to_string(tranID) + " already exists.");
         return;
     }
-    transList[tranID] = { tranID, currentTime(), TranStatus::active, {}, {} };
+    transList[tranID] = { tranID, startTime, TranStatus::active, {}, {}, {}, {} };
+    statusIndex[tranID] = Status::running;
+    live.insert(tranID);
     tranGraph.addTran(tranID);
-    //cout << "Transaction " << tranID << " started." << endl;
+    //sink->onMessage("Transaction " + to_string(tranID) + " started.");
 }
 
-void TransactionManager::readTransaction(const tran_id tranID, const var_id varID) {
+ReadResult TransactionManager::readTransaction(const tran_id tranID, const var_id varID) {
+    ReadResult result = { tranID, varID, ReadStatus::unknown, 0, {}, false };
     if (!transList.count(tranID)) {
-        cout << "Transaction " << tranID << " does not exist." << endl;
-        return;
+        sink->onMessage("Transaction " + to_string(tranID) + " does not exist.");
+        return result;
     }
 
     Transaction& t = transList[tranID];
     vector<site_id> wait;
     if (varID % 2 == 0) {   // is replicated variable
         for (DataManager* site : vector<DataManager*>(sites.begin() + 1, sites.end())) {
-            auto [flag, val] = site->read(varID, t.startTime);
+            if (site->isAvailable() && isLagging(site->getSiteID(), varID, t.startTime))
+                catchUp(site->getSiteID(), varID);
+            auto [flag, val] = onSite(site->getSiteID(), [&](DataManager& dm) { return dm.read(varID, t.startTime); });
             if (flag) {
                 t.read.insert(varID);    // add into readSet
+                t.readMask.set(varID);
 
                 // update graph
                 for (const auto& [otherID, otherTran] : transList) {
-                    if (otherID != tranID && otherTran.write.count(varID))
+                    if (otherID != tranID && otherTran.writeMask.test(varID)) {
                         tranGraph.addDependency(tranID, otherID, SerializationGraph::RW);
+                        contention.record(varID, ContentionProfiler::rwEdge);
+                    }
                 }
-                cout << "x" << varID << ": " << val << endl;
-                return;
+                result.status = ReadStatus::ok;
+                result.value = val;
+                sink->onRead(result);
+                return result;
             }
             else {
                 if (val != -1) {
                     wait.push_back(site->getSiteID());
                     t.read.insert(varID);
+                    t.readMask.set(varID);
                 }
             }
         }
@@ -137,217 +251,723 @@ void TransactionManager::readTransaction(const tran_id tranID, const var_id varI
     else {
         site_id target = 1 + (varID % 10);
         DataManager* site = sites[target];
-        auto [flag, val] = site->read(varID, t.startTime);
+        auto [flag, val] = onSite(target, [&](DataManager& dm) { return dm.read(varID, t.startTime); });
         if (flag) {
             t.read.insert(varID);    // add into readSet
+            t.readMask.set(varID);
 
             // update graph
             for (const auto& [otherID, otherTran] : transList) {
-                if (otherID != tranID && otherTran.write.count(varID))
+                if (otherID != tranID && otherTran.writeMask.test(varID)) {
                     tranGraph.addDependency(tranID, otherID, SerializationGraph::RW);
+                    contention.record(varID, ContentionProfiler::rwEdge);
+                }
             }
-            cout << "x" << varID << ": " << val << endl;
-            return;
+            result.status = ReadStatus::ok;
+            result.value = val;
+            sink->onRead(result);
+            return result;
         }
         else {
             if (val != -1) {
                 wait.push_back(site->getSiteID());
                 t.read.insert(varID);
+                t.readMask.set(varID);
             }
         }
     }
     if (wait.empty()) {
-        t.status = TranStatus::aborted;
-        abortTransaction(tranID);
+        setStatus(t, TranStatus::aborted);
+        result.status = ReadStatus::aborted;
+        sink->onRead(result);
+        abortTransaction(tranID, AbortReason::noReplica);
     }
     else {  // should wait for recover
-        for (site_id id : wait)
-            cout << "T" << tranID << " waits for site " << id << endl;
-        t.status = TranStatus::blocked;
+        result.status = ReadStatus::blocked;
+        result.waitSites = wait;
+        sink->onRead(result);
+        setStatus(t, TranStatus::blocked);
+        blockedSince.emplace(tranID, currentTime());
     }
-    return;
+    return result;
 }
 
-void TransactionManager::writeTransaction(tran_id tranID, const var_id varID, int value) {
+WriteResult TransactionManager::writeTransaction(tran_id tranID, const var_id varID, int value) {
+    WriteResult result = { tranID, varID, value, {} };
     if (!transList.count(tranID)) {
-        cout << "Transaction " << tranID << " does not exist." << endl;
-        return;
+        sink->onMessage("Transaction " + to_string(tranID) + " does not exist.");
+        return result;
     }
     Transaction& t = transList[tranID];
 
     // check WAW conflict and add edge to graph
     for (const auto& [otherID, otherTran] : transList) {
-        if (otherID != tranID && otherTran.write.count(varID)) {
+        if (otherID != tranID && otherTran.writeMask.test(varID)) {
             tranGraph.addDependency(otherID, tranID, SerializationGraph::WW);
+            contention.record(varID, ContentionProfiler::wwEdge);
         }
     }
 
     // check RW conflict
     for (const auto& [otherID, otherTran] : transList) {
-        if (otherID != tranID && otherTran.read.count(varID)) {
+        if (otherID != tranID && otherTran.readMask.test(varID)) {
             tranGraph.addDependency(otherID, tranID, SerializationGraph::RW);
+            contention.record(varID, ContentionProfiler::rwEdge);
         }
     }
 
     // write
     t.write[varID] = make_pair(value, currentTime());
-    bool writeSuccess = false;
+    t.writeMask.set(varID);
     if (varID % 2 == 0) {        // replicated variable
-        for (DataManager* site : vector<DataManager*>(sites.begin() + 1, sites.end())) {
-            if (!site->isAvailable())
-                continue;
-            if (site->hasVariable(varID))
-                writeSuccess = site->write(tranID, varID, value);
+        vector<site_id> targets;
+        for (site_id siteID = 1; siteID <= SITE_NUM; ++siteID) {
+            if (sites[siteID]->isAvailable() && sites[siteID]->hasVariable(varID))
+                targets.push_back(siteID);
+        }
+        vector<char> cached(SITE_NUM + 1, false);      // not vector<bool>, sites fill it at the same time
+        onSites(targets, [&](DataManager& site) { cached[site.getSiteID()] = site.write(tranID, varID, value); });
+        for (site_id siteID : targets) {
+            if (cached[siteID])
+                result.sites.push_back(siteID);
         }
     }
     else {
         site_id target = 1 + (varID % 10);
         DataManager* site = sites[target];
-        if (site->isAvailable())
-            writeSuccess = site->write(tranID, varID, value);
+        if (site->isAvailable() && onSite(target, [&](DataManager& dm) { return dm.write(tranID, varID, value); }))
+            result.sites.push_back(target);
     }
     
-    if (!writeSuccess) {
-        cout << "Write Failed" << endl;
+    sink->onWrite(result);
+    return result;
+}
+
+// same results as one readTransaction() per variable, but every site is asked
+// once for all the variables it serves and the graph is updated in one pass
+vector<ReadResult> TransactionManager::readBatch(const tran_id tranID, const vector<var_id>& varIDs) {
+    vector<ReadResult> results;
+    for (var_id varID : varIDs)
+        results.push_back({ tranID, varID, ReadStatus::unknown, 0, {}, false });
+    if (!transList.count(tranID)) {
+        for (size_t i = 0; i < varIDs.size(); ++i)
+            sink->onMessage("Transaction " + to_string(tranID) + " does not exist.");
+        return results;
     }
+
+    Transaction& t = transList[tranID];
+    vector<bool> served(varIDs.size(), false);
+    vector<bool> seen(varIDs.size(), false);     // some site has a version, read or wait
+
+    // replicated variables move on to the next site until one serves them,
+    // non-replicated ones are only asked at their home site
+    for (site_id siteID = 1; siteID <= SITE_NUM; ++siteID) {
+        DataManager* site = sites[siteID];
+        vector<size_t> asked;
+        vector<var_id> vars;
+        for (size_t i = 0; i < varIDs.size(); ++i) {
+            var_id varID = varIDs[i];
+            bool placed = varID % 2 == 0 ? !served[i] : siteID == 1 + (varID % 10);
+            if (!placed)
+                continue;
+            if (varID % 2 == 0 && site->isAvailable() && isLagging(siteID, varID, t.startTime))
+                catchUp(siteID, varID);
+            asked.push_back(i);
+            vars.push_back(varID);
+        }
+        if (asked.empty())
+            continue;
+
+        vector<pair<bool, int>> reads = onSite(siteID, [&](DataManager& dm) { return dm.readBatch(vars, t.startTime); });
+        for (size_t j = 0; j < asked.size(); ++j) {
+            auto [flag, val] = reads[j];
+            ReadResult& result = results[asked[j]];
+            if (flag) {
+                served[asked[j]] = true;
+                seen[asked[j]] = true;
+                result.value = val;
+            }
+            else if (val != -1) {
+                seen[asked[j]] = true;
+                result.waitSites.push_back(siteID);
+            }
+        }
+    }
+
+    // report in input order; after an abort the rest behave as for a missing transaction
+    var_set readMask;
+    for (size_t i = 0; i < varIDs.size(); ++i) {
+        ReadResult& result = results[i];
+        if (!transList.count(tranID)) {
+            result.waitSites.clear();
+            sink->onMessage("Transaction " + to_string(tranID) + " does not exist.");
+            continue;
+        }
+        if (seen[i]) {
+            t.read.insert(varIDs[i]);
+            t.readMask.set(varIDs[i]);
+        }
+        if (served[i]) {
+            result.waitSites.clear();
+            result.status = ReadStatus::ok;
+            readMask.set(varIDs[i]);
+            sink->onRead(result);
+        }
+        else if (!result.waitSites.empty()) {   // should wait for recover
+            result.status = ReadStatus::blocked;
+            sink->onRead(result);
+            setStatus(t, TranStatus::blocked);
+            blockedSince.emplace(tranID, currentTime());
+        }
+        else {
+            setStatus(t, TranStatus::aborted);
+            result.status = ReadStatus::aborted;
+            sink->onRead(result);
+            abortTransaction(tranID, AbortReason::noReplica);
+        }
+    }
+    if (!transList.count(tranID) || readMask.none())
+        return results;
+
+    // update graph
+    for (const auto& [otherID, otherTran] : transList) {
+        if (otherID != tranID && (otherTran.writeMask & readMask).any()) {
+            tranGraph.addDependency(tranID, otherID, SerializationGraph::RW);
+            contention.record(otherTran.writeMask & readMask, ContentionProfiler::rwEdge);
+        }
+    }
+    return results;
 }
 
-void TransactionManager::endTransaction(tran_id tranID) {
+// same results as one writeTransaction() per variable, but every site is sent
+// one request with all the writes it holds and the graph is updated in one pass
+vector<WriteResult> TransactionManager::writeBatch(const tran_id tranID, const vector<pair<var_id, int>>& writes) {
+    vector<WriteResult> results;
+    for (const auto& [varID, value] : writes)
+        results.push_back({ tranID, varID, value, {} });
     if (!transList.count(tranID)) {
-        //cout << "Transaction " << tranID << " does not exist." << endl;
-        return;
+        for (size_t i = 0; i < writes.size(); ++i)
+            sink->onMessage("Transaction " + to_string(tranID) + " does not exist.");
+        return results;
     }
-    
+    Transaction& t = transList[tranID];
+
+    var_set writeMask;
+    for (const auto& [varID, value] : writes)
+        writeMask.set(varID);
+
+    // WAW and RW conflicts; as with writes one at a time, the last variable
+    // shared with the other transaction decides the edge type
+    for (const auto& [otherID, otherTran] : transList) {
+        if (otherID == tranID || ((otherTran.writeMask | otherTran.readMask) & writeMask).none())
+            continue;
+        contention.record(otherTran.writeMask & writeMask, ContentionProfiler::wwEdge);
+        contention.record(otherTran.readMask & writeMask, ContentionProfiler::rwEdge);
+        for (auto it = writes.rbegin(); it != writes.rend(); ++it) {
+            if (otherTran.readMask.test(it->first)) {
+                tranGraph.addDependency(otherID, tranID, SerializationGraph::RW);
+                break;
+            }
+            if (otherTran.writeMask.test(it->first)) {
+                tranGraph.addDependency(otherID, tranID, SerializationGraph::WW);
+                break;
+            }
+        }
+    }
+
+    // write
+    for (const auto& [varID, value] : writes)
+        t.write[varID] = make_pair(value, currentTime());
+    t.writeMask |= writeMask;
+    vector<vector<size_t>> sent(SITE_NUM + 1);
+    vector<vector<pair<var_id, int>>> payload(SITE_NUM + 1);
+    vector<vector<bool>> cached(SITE_NUM + 1);
+    vector<site_id> targets;
+    for (site_id siteID = 1; siteID <= SITE_NUM; ++siteID) {
+        DataManager* site = sites[siteID];
+        if (!site->isAvailable())
+            continue;
+        for (size_t i = 0; i < writes.size(); ++i) {
+            var_id varID = writes[i].first;
+            if (varID % 2 == 0 ? site->hasVariable(varID) : siteID == 1 + (varID % 10)) {
+                sent[siteID].push_back(i);
+                payload[siteID].push_back(writes[i]);
+            }
+        }
+        if (!payload[siteID].empty())
+            targets.push_back(siteID);
+    }
+
+    onSites(targets, [&](DataManager& site) {
+        cached[site.getSiteID()] = site.writeBatch(tranID, payload[site.getSiteID()]);
+    });
+    for (site_id siteID : targets) {
+        for (size_t j = 0; j < sent[siteID].size(); ++j) {
+            if (cached[siteID][j])
+                results[sent[siteID][j]].sites.push_back(siteID);
+        }
+    }
+
+    for (const WriteResult& result : results)
+        sink->onWrite(result);
+    return results;
+}
+
+CommitResult TransactionManager::endTransaction(tran_id tranID) {
+    return finishEnd(tranID, SerializationGraph::undecided);
+}
+
+// verdict: the cycle check already done for a batch, if any
+CommitResult TransactionManager::finishEnd(const tran_id tranID, SerializationGraph::Verdict verdict) {
+    if (!transList.count(tranID)) {
+        //sink->onMessage("Transaction " + to_string(tranID) + " does not exist.");
+        return { tranID, false, AbortReason::unknown, {} };
+    }
+
+    AbortReason reason = validate(tranID, verdict);
+    if (reason != AbortReason::none)
+        return abortTransaction(tranID, reason);
+    return commitTransaction(tranID);
+}
+
+// returns AbortReason::none when the transaction can commit
+AbortReason TransactionManager::prepareTransaction(const tran_id tranID) {
+    return validate(tranID, SerializationGraph::undecided);
+}
+
+AbortReason TransactionManager::validate(const tran_id tranID, SerializationGraph::Verdict verdict) {
+    if (!transList.count(tranID))
+        return AbortReason::unknown;
+
     Transaction& t = transList[tranID];
     
     /**   abort directly   **/ 
-    if (t.status == TranStatus::aborted || t.status == TranStatus::blocked) {
-        abortTransaction(tranID);
-        return;
-    }
+    if (t.status == TranStatus::aborted)
+        return AbortReason::firstCommitter;
+    if (t.status == TranStatus::blocked)
+        return AbortReason::blockedRead;
 
     /**   check whether write can commit   **/
     for (const auto& [varID, writeValue] : t.write) {
         // is replicated variable, check for cacheWrite consistency
         if (varID % 2 == 0) {   
+            int available = 0;
             for (DataManager* site : vector<DataManager*>(sites.begin() + 1, sites.end())) {
-                if (writeValue.second < site->getFailTime()) {
-                    abortTransaction(tranID);
-                    return;
-                }
+                if (writeValue.second < site->getFailTime())
+                    return AbortReason::siteFailure;
+                available += site->isAvailable();
             }
+            if (policy == ReplicationPolicy::majorityQuorum && available < getSyncReplicas())
+                return AbortReason::noQuorum;
         }
         else {      // for non-replicated variable
             site_id targetID = 1 + (varID % 10);
             DataManager* targetSite = sites[targetID];
-            if (!targetSite->isAvailable()) {
-                abortTransaction(tranID);
-                return;
-            }
-            if (writeValue.second < targetSite->getFailTime()) {
-                abortTransaction(tranID);
-                return;
-            }
+            if (!targetSite->isAvailable())
+                return AbortReason::siteFailure;
+            if (writeValue.second < targetSite->getFailTime())
+                return AbortReason::siteFailure;
         }
     }
 
     /**   detect cycle   **/ 
-    unordered_map<tran_id, Status> statusList;
-    for (const auto& [id, tran] : transList) {
-        if (tran.status == TranStatus::committed)
-            statusList[id] = Status::commit;
-        else if (tran.status == TranStatus::active)
-            statusList[id] = Status::running;
-    }
-    if (tranGraph.hasCycle(tranID, statusList)) {
-        abortTransaction(tranID);
-        return;
+    if (verdict == SerializationGraph::undecided)
+        verdict = tranGraph.onCycle(tranID, statusIndex) ? SerializationGraph::cycle : SerializationGraph::noCycle;
+    if (verdict == SerializationGraph::cycle) {
+        // blame the variables shared with its neighbours in the graph
+        var_set blamed;
+        auto [outEdges, inEdges] = tranGraph.getEdges(tranID);
+        for (const auto& edges : { outEdges, inEdges }) {
+            for (const auto& [otherID, type] : edges) {
+                auto other = transList.find(otherID);
+                if (other == transList.end())
+                    continue;
+                const Transaction& o = other->second;
+                blamed |= (t.readMask & o.writeMask) | (t.writeMask & (o.readMask | o.writeMask));
+            }
+        }
+        contention.record(blamed, ContentionProfiler::cycleAbort);
+        return AbortReason::cycle;
     }
+    return AbortReason::none;
+}
 
-
+vector<SiteWrite> TransactionManager::commitPrepared(const tran_id tranID) {
     /**   check WAW, first committer wins   **/
+    Transaction& t = transList[tranID];
     vector<tran_id> conflicts = getWAWConflict(tranID);
-    if (!conflicts.empty()) {
-        for (tran_id c : conflicts)
-            transList[c].status = TranStatus::aborted;
+    for (tran_id c : conflicts) {
+        Transaction& loser = transList[c];
+        if (loser.status != TranStatus::aborted)
+            contention.record(loser.writeMask & t.writeMask, ContentionProfiler::firstCommitterAbort);
+        setStatus(loser, TranStatus::aborted);
     }
 
-    commitTransaction(tranID);
-}
+    // plan which sites commit and which discard each write, then send every
+    // site its part at once; applied keeps the variable-then-site order
+    struct Step {
+        site_id site;
+        var_id var;
+        int value;
+        bool commit;        // false: a follower discards it and catches up in background
+    };
+    vector<Step> steps;
+    vector<vector<size_t>> stepsOf(SITE_NUM + 1);
+    vector<site_id> targets;
+    for (const auto& [varID, writeValue] : t.write) {
+        int synced = 0;
+        for (site_id siteID = 1; siteID <= SITE_NUM; ++siteID) {
+            if (!sites[siteID]->isAvailable())
+                continue;
+            if (varID % 2 != 0 && siteID != (1 + (varID % 10)))      // non-replicated variables only write to target site
+                continue;
+            bool follower = varID % 2 == 0 && synced >= getSyncReplicas();
+            if (follower) {
+                ReplicaLog& log = replicaLogs[siteID];
+                log.pending.push_back({ varID, writeValue.first, currentTime() });
+                ++log.pendingPerVar[varID];
+            }
+            else
+                ++synced;
+            if (stepsOf[siteID].empty())
+                targets.push_back(siteID);
+            stepsOf[siteID].push_back(steps.size());
+            steps.push_back({ siteID, varID, writeValue.first, !follower });
+        }
+    }
 
-void TransactionManager::abortTransaction(const tran_id tranID) {
-    Transaction& t = transList[tranID];
-    for (DataManager* site : vector<DataManager*>(sites.begin() + 1, sites.end())) {
-        site->abortWrite(tranID);
+    vector<char> done(steps.size(), false);
+    onSites(targets, [&](DataManager& site) {
+        for (size_t i : stepsOf[site.getSiteID()]) {
+            if (steps[i].commit)
+                done[i] = site.commitWrite(tranID, steps[i].var, steps[i].value);
+            else
+                site.discardWrite(tranID, steps[i].var);
+        }
+    });
+    vector<SiteWrite> applied;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (done[i])
+            applied.push_back({ steps[i].site, steps[i].var, steps[i].value });
     }
-    t.status = TranStatus::aborted;
+    setStatus(t, TranStatus::committed);
+    ++committedCount;
+    return applied;
+}
+
+void TransactionManager::abortPrepared(const tran_id tranID) {
+    if (!transList.count(tranID))
+        return;
+
+    vector<site_id> all;
+    for (site_id siteID = 1; siteID <= SITE_NUM; ++siteID)
+        all.push_back(siteID);
+    onSites(all, [tranID](DataManager& site) { site.abortWrite(tranID); });
     transList.erase(tranID);
+    statusIndex.erase(tranID);
+    live.erase(tranID);
+    blockedSince.erase(tranID);
     tranGraph.removeTran(tranID);
-    cout << "T" << tranID << " aborts" << endl;
-    cout << endl;
 }
 
-void TransactionManager::commitTransaction(const tran_id tranID) {
-    Transaction& t = transList[tranID];
+CommitResult TransactionManager::abortTransaction(const tran_id tranID, AbortReason reason) {
+    abortPrepared(tranID);
+    CommitResult result = { tranID, false, reason, {} };
+    sink->onCommit(result);
+    return result;
+}
 
-    for (const auto& [varID, writeValue] : t.write) {
-        for (DataManager* site : vector<DataManager*>(sites.begin() + 1, sites.end())) {
-            if (!site->isAvailable())
-                continue;
-            if (varID % 2 != 0 && site->getSiteID() != (1 + (varID % 10)))      // non-replicated variables only write to target site
-                continue;
-            site->commitWrite(tranID, varID, writeValue.first);
+CommitResult TransactionManager::commitTransaction(const tran_id tranID) {
+    CommitResult result = { tranID, true, AbortReason::none, commitPrepared(tranID) };
+    sink->onCommit(result);
+    return result;
+}
+
+void TransactionManager::setAdmission(const AdmissionConfig& config) {
+    admission = config;
+}
+
+vector<HotVariable> TransactionManager::hotVariables(size_t k) const {
+    return contention.top(k);
+}
+
+void TransactionManager::setCommitBatch(size_t n) {
+    flush();
+    commitBatch = max<size_t>(n, 1);
+}
+
+// validate the collected ends with one traversal of the graph, shared by the
+// batch (see SerializationGraph::BatchCheck), then end them in arrival order;
+// only an end the traversal cannot decide is searched with onCycle()
+void TransactionManager::flush() {
+    if (pendingEnds.empty())
+        return;
+    vector<PendingEnd> batch;
+    batch.swap(pendingEnds);
+
+    // only active transactions reach the cycle check, blocked and aborted ones
+    // stay so until the next recover, which comes after the batch
+    vector<tran_id> candidates;
+    unordered_set<tran_id> unchecked;
+    for (const PendingEnd& end : batch) {
+        if (getStatus(end.tranID) == TranStatus::active && unchecked.insert(end.tranID).second)
+            candidates.push_back(end.tranID);
+    }
+    SerializationGraph::BatchCheck check(tranGraph, candidates, statusIndex);
+
+    double now = globalTime;
+    for (const PendingEnd& end : batch) {
+        globalTime = end.time;      // as if the end had run when it arrived
+        SerializationGraph::Verdict verdict = SerializationGraph::undecided;
+        if (unchecked.erase(end.tranID) && getStatus(end.tranID) == TranStatus::active)
+            verdict = check.verdict(end.tranID);
+        if (finishEnd(end.tranID, verdict).committed)
+            check.committed(end.tranID);
+        expire();
+        admit();
+        propagate();
+    }
+    globalTime = now;
+}
+
+AdmissionStats TransactionManager::admissionStats() const {
+    AdmissionStats stats = admitStats;
+    stats.active = transList.size() - committedCount;
+    stats.blocked = blockedSince.size();
+    stats.queued = admissionQueue.size();
+    stats.meanQueueWait = stats.admitted > 0 ? totalQueueWait / stats.admitted : 0.0;
+    return stats;
+}
+
+bool TransactionManager::canAdmit() const {
+    if (admission.maxActive > 0 && transList.size() - committedCount >= admission.maxActive)
+        return false;
+    if (admission.maxBlocked > 0 && blockedSince.size() >= admission.maxBlocked)
+        return false;
+    return true;
+}
+
+// begin queued transactions while the limits allow, replaying the commands held for them
+void TransactionManager::admit() {
+    while (!admissionQueue.empty() && canAdmit()) {
+        auto [tranID, requested] = admissionQueue.front();
+        admissionQueue.pop_front();
+        deque<Command> held = move(heldCommands[tranID]);
+        heldCommands.erase(tranID);
+
+        double wait = currentTime() - requested;
+        ++admitStats.admitted;
+        totalQueueWait += wait;
+        admitStats.maxQueueWait = max(admitStats.maxQueueWait, wait);
+        sink->onMessage("T" + to_string(tranID) + " admitted");
+
+        beginTransaction(tranID, currentTime());
+        for (const Command& cmd : held)
+            dispatch(cmd);
+    }
+}
+
+// abort transactions blocked on a failed site for longer than the timeout
+void TransactionManager::expire() {
+    if (admission.blockedTimeout <= 0.0)
+        return;
+
+    vector<tran_id> expired;
+    for (const auto& [tranID, since] : blockedSince) {
+        if (currentTime() - since >= admission.blockedTimeout - 1e-9)     // tolerate clock rounding
+            expired.push_back(tranID);
+    }
+    for (tran_id tranID : expired) {
+        ++admitStats.timedOut;
+        abortTransaction(tranID, AbortReason::timeout);
+    }
+}
+
+void TransactionManager::setReplicationPolicy(ReplicationPolicy p, int batch) {
+    policy = p;
+    if (batch > 0)
+        batchSize = batch;
+}
+
+// number of replicas written synchronously at commit
+int TransactionManager::getSyncReplicas() const {
+    switch (policy) {
+    case ReplicationPolicy::majorityQuorum:
+        return SITE_NUM / 2 + 1;
+    case ReplicationPolicy::primaryAsync:
+        return 1;
+    default:
+        return SITE_NUM;
+    }
+}
+
+// whether the site still misses a commit of varID visible to a snapshot at startTime
+bool TransactionManager::isLagging(site_id siteID, var_id varID, double startTime) const {
+    const ReplicaLog& log = replicaLogs[siteID];
+    auto it = log.pendingPerVar.find(varID);
+    if (it == log.pendingPerVar.end() || it->second == 0)
+        return false;
+    for (const ReplicaLog::Entry& e : log.pending) {
+        if (e.var == varID && e.commitTime <= startTime)
+            return true;
+    }
+    return false;
+}
+
+// apply every pending update of varID to the site, in commit order
+void TransactionManager::catchUp(site_id siteID, var_id varID) {
+    ReplicaLog& log = replicaLogs[siteID];
+    vector<ReplicaLog::Entry> due;
+    for (auto it = log.pending.begin(); it != log.pending.end();) {
+        if (it->var != varID) {
+            ++it;
+            continue;
         }
+        due.push_back(*it);
+        ++log.applied;
+        --log.pendingPerVar[varID];
+        it = log.pending.erase(it);
     }
-    t.status = TranStatus::committed;
-    cout << "T" << tranID << " commits" << endl;
-    cout << endl;
+    if (due.empty())
+        return;
+    onSite(siteID, [&due](DataManager& site) {
+        for (const ReplicaLog::Entry& e : due)
+            site.applyReplicated(e.var, e.value, e.commitTime);
+    });
 }
 
-vector<tran_id> TransactionManager::getWAWConflict(const tran_id tranID) {
-    unordered_set<tran_id> conflictSet;
+// background replication: each available follower applies up to batchSize updates per tick
+void TransactionManager::propagate() {
+    vector<size_t> due(SITE_NUM + 1, 0);
+    vector<site_id> targets;
+    for (site_id i = 1; i <= SITE_NUM; ++i) {
+        ReplicaLog& log = replicaLogs[i];
+        if (log.pending.empty())
+            continue;
+        log.maxLag = max(log.maxLag, currentTime() - log.pending.front().commitTime);
+        if (!sites[i]->isAvailable())
+            continue;
+        due[i] = min(static_cast<size_t>(max(batchSize, 0)), log.pending.size());
+        if (due[i] > 0)
+            targets.push_back(i);
+    }
 
-    const auto& [outEdges, inEdges] = tranGraph.getEdges(tranID);
+    // each site only reads the front of its own log, which is left alone until all are done
+    onSites(targets, [&](DataManager& site) {
+        const ReplicaLog& log = replicaLogs[site.getSiteID()];
+        for (size_t n = 0; n < due[site.getSiteID()]; ++n)
+            site.applyReplicated(log.pending[n].var, log.pending[n].value, log.pending[n].commitTime);
+    });
+    for (site_id i : targets) {
+        ReplicaLog& log = replicaLogs[i];
+        for (size_t n = 0; n < due[i]; ++n) {
+            ++log.applied;
+            --log.pendingPerVar[log.pending.front().var];
+            log.pending.pop_front();
+        }
+    }
+}
 
-    for (const auto& [v, type] : outEdges) {
-        if (type == SerializationGraph::WW)
-            conflictSet.insert(v);
+vector<ReplicaStats> TransactionManager::replicationLag() {
+    vector<ReplicaStats> stats;
+    for (site_id i = 1; i <= SITE_NUM; ++i) {
+        const ReplicaLog& log = replicaLogs[i];
+        double lag = log.pending.empty() ? 0.0 : currentTime() - log.pending.front().commitTime;
+        stats.push_back({ i, log.pending.size(), log.applied, lag, log.maxLag });
     }
+    sink->onLag(stats);
+    return stats;
+}
+
+bool TransactionManager::hasTransaction(tran_id tranID) const {
+    return transList.count(tranID) > 0;
+}
 
-    for (const auto& [u, type] : inEdges) {
-        if (type == SerializationGraph::WW)
-            conflictSet.insert(u);
+// snapshot time of the transaction, -1 when it does not exist
+double TransactionManager::getStartTime(tran_id tranID) const {
+    auto it = transList.find(tranID);
+    return it == transList.end() ? -1.0 : it->second.startTime;
+}
+
+// transactions that aborted are no longer listed
+TranStatus TransactionManager::getStatus(tran_id tranID) const {
+    auto it = transList.find(tranID);
+    if (it == transList.end())
+        return heldCommands.count(tranID) ? TranStatus::queued : TranStatus::aborted;
+    return it->second.status;
+}
+
+DataManager* TransactionManager::getSite(site_id siteID) const {
+    if (siteID < 1 || siteID > SITE_NUM)
+        return nullptr;
+    return sites[siteID];
+}
+
+vector<pair<tran_id, tran_id>> TransactionManager::getPortalPaths(const tran_id tranID, const unordered_set<tran_id>& portals) const {
+    return tranGraph.getPortalPaths(tranID, portals, getStatusList());
+}
+
+const unordered_map<tran_id, Status>& TransactionManager::getStatusList() const {
+    return statusIndex;
+}
+
+// keeps statusIndex and live in step with the transaction status
+void TransactionManager::setStatus(Transaction& t, TranStatus status) {
+    t.status = status;
+    if (status == TranStatus::committed) {
+        statusIndex[t.tranID] = Status::commit;
+        live.erase(t.tranID);
+    }
+    else if (status == TranStatus::active)
+        statusIndex[t.tranID] = Status::running;
+    else
+        statusIndex.erase(t.tranID);
+}
+
+vector<tran_id> TransactionManager::getWAWConflict(const tran_id tranID) {
+    vector<tran_id> conflicts;
+    const var_set& writeMask = transList[tranID].writeMask;
+    if (writeMask.none())
+        return conflicts;
+
+    // every pair of live transactions writing the same variable has a WW edge,
+    // so overlapping write signatures give exactly the WW neighbours; committed
+    // writers are left out, an earlier committer stays in the graph
+    for (tran_id otherID : live) {
+        if (otherID != tranID && (transList[otherID].writeMask & writeMask).any())
+            conflicts.push_back(otherID);
     }
-    return vector<tran_id>(conflictSet.begin(), conflictSet.end());
+    return conflicts;
 }
 
 void TransactionManager::fail(site_id siteID) {
     if (siteID < 1 || siteID > SITE_NUM) {
-        cout << "Invalid site ID" << endl;
+        sink->onMessage("Invalid site ID");
         return;
     }
     
     DataManager* site = sites[siteID];
     if (!site->isAvailable()) {
-        cout << "Site" << siteID << " is already failed" << endl;
+        sink->onMessage("Site" + to_string(siteID) + " is already failed");
         return;
     }
-    site->setAvailable(false);
-    site->clearCache();
+    onSite(siteID, [](DataManager& dm) {
+        dm.setAvailable(false);
+        dm.clearCache();
+    });
     
     // debug
-    // cout << "site" << siteID << " fail" << endl;
+    // sink->onMessage("site" + to_string(siteID) + " fail");
 }
 
 void TransactionManager::recover(site_id siteID) {
     if (siteID < 1 || siteID > SITE_NUM) {
-        cout << "Invalid site" << endl;
+        sink->onMessage("Invalid site");
         return;
     }
     
     DataManager* site = sites[siteID];
-    site->setAvailable(true);
-    const auto targetSet = site->getVariables();
+    onSite(siteID, [](DataManager& dm) { dm.setAvailable(true); });
 
     for (auto& [tranID, tran] : transList) {
         if (tran.status != TranStatus::blocked)
@@ -355,47 +975,88 @@ void TransactionManager::recover(site_id siteID) {
 
         for (var_id varID : tran.read) {
             if (site->hasVariable(varID)) {
-                auto [flag, val] = site->read(varID, tran.startTime);
+                if (isLagging(siteID, varID, tran.startTime))
+                    catchUp(siteID, varID);
+                auto [flag, val] = onSite(siteID, [&](DataManager& dm) { return dm.read(varID, tran.startTime); });
                 if (flag) {
-                    cout << "T" << tranID << " unblocked" << endl;
-                    cout << "x" << varID << ": " << val << endl;
+                    ReadResult result = { tranID, varID, ReadStatus::ok, val, {}, true };
+                    sink->onRead(result);
                     // update graph
                     for (const auto& [otherID, otherTran] : transList) {
-                        if (otherID != tranID && otherTran.write.count(varID))
+                        if (otherID != tranID && otherTran.writeMask.test(varID)) {
                             tranGraph.addDependency(tranID, otherID, SerializationGraph::RW);
+                            contention.record(varID, ContentionProfiler::rwEdge);
+                        }
                     }
-                    tran.status = TranStatus::active;
+                    setStatus(tran, TranStatus::active);
+                    blockedSince.erase(tranID);
                 }
             }
         }
     }
     
     // debug
-    // cout << "site" << siteID << " recover" << endl;
+    // sink->onMessage("site" + to_string(siteID) + " recover");
 }
 
-void TransactionManager::dump() {
+vector<SiteSnapshot> TransactionManager::dump() {
+    vector<SiteSnapshot> snapshot;
     for (DataManager* site : vector<DataManager*>(sites.begin() + 1, sites.end())) {
-        site_id siteID = site->getSiteID();
-        cout << "site " << siteID << " - ";
-
-        const auto& varList = site->getVariables();
-        if (varList.empty()) {
-            cout << "\n";
-            continue;
+        SiteSnapshot current = { site->getSiteID(), {} };
+        for (const auto& [id, var] : site->getVariables()) {
+            current.values.emplace_back(id, var.value);
         }
+        sort(current.values.begin(), current.values.end());
+        snapshot.push_back(move(current));
+    }
+    sink->onDump(snapshot);
+    return snapshot;
+}
 
-        vector<pair<var_id, int>> sorted;
-        for (const auto& [id, var] : varList) {
-            sorted.emplace_back(id, var.value);
+// every site's variables as its own version store had them at time
+vector<SiteSnapshot> TransactionManager::dumpAt(double time) {
+    vector<SiteSnapshot> snapshot;
+    for (DataManager* site : vector<DataManager*>(sites.begin() + 1, sites.end())) {
+        SiteSnapshot current = { site->getSiteID(), {} };
+        for (const auto& [id, var] : site->getVariables()) {
+            auto [commitTime, value] = site->readAt(id, time);
+            if (commitTime >= 0)
+                current.values.emplace_back(id, value);
         }
-        sort(sorted.begin(), sorted.end());
+        sort(current.values.begin(), current.values.end());
+        snapshot.push_back(move(current));
+    }
+    sink->onDump(snapshot);
+    return snapshot;
+}
 
-        for (const auto& [id, val] : sorted) {
-            cout << "x" << id << ": " << val << ", ";
-        }
-        cout << endl;
+unique_ptr<SnapshotExport> TransactionManager::exportSnapshot(ostream& out, ExportFormat format, double time, size_t threads) {
+    flush();    // collected ends come before the snapshot
+    if (time < 0)
+        time = currentTime();
+    return make_unique<SnapshotExport>(vector<DataManager*>(sites.begin() + 1, sites.end()), time, out, format, threads);
+}
+
+// non-transactional read of a past value: no transaction, no graph, served by
+// the first live replica whose history is complete up to time
+HistoryRead TransactionManager::readAt(var_id varID, double time) {
+    HistoryRead result = { varID, time, false, 0, 0 };
+    for (DataManager* site : vector<DataManager*>(sites.begin() + 1, sites.end())) {
+        if (!site->isAvailable() || !site->hasVariable(varID))
+            continue;
+        if (isLagging(site->getSiteID(), varID, time))
+            catchUp(site->getSiteID(), varID);
+
+        auto [commitTime, value] = site->readAt(varID, time);
+        if (commitTime < 0 || !site->wasUp(commitTime, time))
+            continue;   // may have missed a commit while it was down
+        result.found = true;
+        result.value = value;
+        result.site = site->getSiteID();
+        break;
     }
+    sink->onHistory(result);
+    return result;
 }
 
 void TransactionManager::queryState() {
@@ -405,15 +1066,15 @@ void TransactionManager::queryState() {
 
     const auto& cacheWrites = site->getAllCacheWrites();
     if (cacheWrites.empty()) {
-        std::cout << "  No cacheWrites found.\n";
+        sink->onMessage("  No cacheWrites found.");
     }
     else {
         for (const auto& [tranID, writes] : cacheWrites) {
-            std::cout << "  Transaction " << tranID << ":\n";
+            sink->onMessage("  Transaction " + to_string(tranID) + ":");
             for (const auto& [varID, value] : writes) {
-                std::cout << "    x" << varID << " = " << value << "\n";
+                sink->onMessage("    x" + to_string(varID) + " = " + to_string(value));
             }
         }
     }
-    cout << "============" << endl;
+    sink->onMessage("============");
 }
\ No newline at end of file
@@ -0,0 +1,255 @@
+/*****************************************************************************
+ * Author:        Xinyu Li
+ * Created:       10-19-2026
+ * Last Edited:   10-19-2026
+ * Description:   This file implements the VersionChain and Epoch classes.
+ *
+ *                Memory ordering:
+ *                 - The writer publishes a version with a release store of
+ *                   the link that points to it; readers follow links with
+ *                   acquire loads, so they always see complete versions.
+ *                 - A reader stores its pinned epoch and then fences before
+ *                   reading the chain; the writer unlinks a version, then
+ *                   advances the epoch and fences before scanning the pins.
+ *                   Either the writer sees the pin, or the reader does not
+ *                   see the unlinked version.
+ ****************************************************************************/
+
+#include <thread>
+#include "VersionChain.h"
+
+/**   Epoch   **/
+
+Epoch::State::~State() {
+    for (const Retired& r : limbo)
+        r.deleter(r.node);
+}
+
+Epoch::Participant::Participant() {
+    State& s = state();
+    while (true) {
+        for (Slot& candidate : s.slots) {
+            bool expected = false;
+            if (candidate.used.compare_exchange_strong(expected, true, memory_order_acq_rel)) {
+                slot = &candidate;
+                return;
+            }
+        }
+        this_thread::yield();   // every slot taken, wait for a thread to exit
+    }
+}
+
+Epoch::Participant::~Participant() {
+    slot->epoch.store(idle, memory_order_release);
+    slot->used.store(false, memory_order_release);
+}
+
+Epoch::State& Epoch::state() {
+    static State s;
+    return s;
+}
+
+Epoch::Participant& Epoch::participant() {
+    thread_local Participant p;
+    return p;
+}
+
+Epoch::Guard::Guard() {
+    Participant& p = participant();
+    if (p.depth++ > 0)
+        return;
+    p.slot->epoch.store(state().global.load(memory_order_acquire), memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+Epoch::Guard::~Guard() {
+    Participant& p = participant();
+    if (--p.depth == 0)
+        p.slot->epoch.store(idle, memory_order_release);
+}
+
+// node must already be unreachable for new readers
+void Epoch::retire(void* node, void (*deleter)(void*)) {
+    State& s = state();
+    lock_guard<mutex> lk(s.lock);
+    s.limbo.push_back({ node, deleter, s.global.fetch_add(1, memory_order_acq_rel) });
+    if (s.limbo.size() >= 64)
+        reclaimLocked(s);
+}
+
+size_t Epoch::reclaim() {
+    State& s = state();
+    lock_guard<mutex> lk(s.lock);
+    return reclaimLocked(s);
+}
+
+size_t Epoch::pending() {
+    State& s = state();
+    lock_guard<mutex> lk(s.lock);
+    return s.limbo.size();
+}
+
+size_t Epoch::reclaimLocked(State& s) {
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t oldest = idle;
+    for (const Slot& slot : s.slots)
+        oldest = min(oldest, slot.epoch.load(memory_order_acquire));
+
+    size_t freed = 0;
+    auto keep = s.limbo.begin();
+    for (auto it = s.limbo.begin(); it != s.limbo.end(); ++it) {
+        if (it->epoch < oldest) {
+            it->deleter(it->node);
+            ++freed;
+        }
+        else
+            *keep++ = *it;
+    }
+    s.limbo.erase(keep, s.limbo.end());
+    return freed;
+}
+
+/**   VersionChain   **/
+
+// copies are only made while no other thread uses either chain
+VersionChain::VersionChain(const VersionChain& other) {
+    copyFrom(other);
+}
+
+VersionChain& VersionChain::operator=(const VersionChain& other) {
+    if (this != &other) {
+        clear();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+VersionChain::~VersionChain() {
+    clear();
+}
+
+void VersionChain::destroy(void* version) {
+    delete static_cast<Version*>(version);
+}
+
+void VersionChain::clear() {
+    Version* v = newest.exchange(nullptr, memory_order_relaxed);
+    while (v) {
+        Version* older = v->older.load(memory_order_relaxed);
+        delete v;
+        v = older;
+    }
+    count = 0;
+}
+
+void VersionChain::copyFrom(const VersionChain& other) {
+    vector<pair<double, int>> versions;
+    for (Version* v = other.newest.load(memory_order_acquire); v; v = v->older.load(memory_order_acquire))
+        versions.emplace_back(v->commitTime, v->value);
+    for (auto it = versions.rbegin(); it != versions.rend(); ++it)
+        insert(it->first, it->second);
+}
+
+// height the skip link of a version at height jumps to; the same choice as
+// the block index skip list of Bitcoin, which bounds lookups by O(log n)
+size_t VersionChain::skipHeight(size_t height) {
+    auto invertLowestOne = [](size_t n) { return n & (n - 1); };
+    if (height < 2)
+        return 0;
+    return (height & 1) ? invertLowestOne(invertLowestOne(height - 1)) + 1 : invertLowestOne(height);
+}
+
+// writer only; the newest version at or below height, or the oldest one left
+VersionChain::Version* VersionChain::ancestor(Version* from, size_t height) {
+    while (from && from->height > height) {
+        Version* far = from->skip.load(memory_order_relaxed);
+        Version* older = from->older.load(memory_order_relaxed);
+        if (far && far->height >= height)
+            from = far;
+        else if (older)
+            from = older;
+        else
+            break;
+    }
+    return from;
+}
+
+// writer only; a version with the same commit time is replaced
+void VersionChain::insert(double commitTime, int value) {
+    atomic<Version*>* link = &newest;
+    Version* next = link->load(memory_order_relaxed);
+    while (next && next->commitTime > commitTime) {     // usually stops at the head
+        link = &next->older;
+        next = link->load(memory_order_relaxed);
+    }
+
+    Version* version = new Version{ commitTime, value, 0, { next }, { nullptr } };
+    if (next && next->commitTime == commitTime) {
+        version->height = next->height;
+        version->older.store(next->older.load(memory_order_relaxed), memory_order_relaxed);
+        version->skip.store(next->skip.load(memory_order_relaxed), memory_order_relaxed);
+        link->store(version, memory_order_release);
+        Epoch::retire(next, destroy);
+        return;
+    }
+    if (next) {
+        // heights only stay exact for appends; any older version is a valid skip target
+        version->height = next->height + 1;
+        version->skip.store(ancestor(next, skipHeight(version->height)), memory_order_relaxed);
+    }
+    link->store(version, memory_order_release);
+    ++count;
+}
+
+// latest version committed at or before time, as (commit time, value);
+// commit time is -1 when there is none. Lock-free, any thread.
+pair<double, int> VersionChain::latestAt(double time) const {
+    Epoch::Guard guard;
+    Version* v = newest.load(memory_order_acquire);
+    while (v && v->commitTime > time) {
+        Version* far = v->skip.load(memory_order_acquire);
+        if (far && far->commitTime > time)
+            v = far;        // every version in between is newer than far
+        else
+            v = v->older.load(memory_order_acquire);
+    }
+    if (!v)
+        return { -1.0, -1 };
+    return { v->commitTime, v->value };
+}
+
+// writer only; drops the versions no snapshot at or after before can read,
+// keeping the latest one committed at or before it. Returns the count dropped.
+size_t VersionChain::truncate(double before) {
+    Version* keep = newest.load(memory_order_relaxed);
+    while (keep && keep->commitTime > before)
+        keep = keep->older.load(memory_order_relaxed);
+    if (!keep)
+        return 0;
+
+    Version* v = keep->older.exchange(nullptr, memory_order_acq_rel);
+    if (!v)
+        return 0;
+
+    // skip links into the dropped versions now land on keep
+    for (Version* w = newest.load(memory_order_relaxed); w != keep; w = w->older.load(memory_order_relaxed)) {
+        Version* far = w->skip.load(memory_order_relaxed);
+        if (far && far->commitTime < keep->commitTime)
+            w->skip.store(keep, memory_order_release);
+    }
+    keep->skip.store(nullptr, memory_order_release);
+
+    size_t dropped = 0;
+    while (v) {
+        Version* older = v->older.load(memory_order_relaxed);
+        Epoch::retire(v, destroy);
+        ++dropped;
+        v = older;
+    }
+    count -= dropped;
+    return dropped;
+}
+
+size_t VersionChain::size() const {
+    return count;
+}
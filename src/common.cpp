@@ -1,7 +1,7 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-05-2024
- * Last Edited:   12-06-2024
+ * Last Edited:   10-19-2026
  * Description:   [Brief description of the functionality implemented in this file.
  *                 For example, "This file implements the main logic for processing
  *                 user input and managing system states."]
@@ -15,7 +15,7 @@
 
 #include "common.h"
 
-double globalTime = 0.0;
+thread_local double globalTime = 0.0;
 
 double currentTime() {
     //return static_cast<double>(time(nullptr));
@@ -41,4 +41,150 @@ vector<string> split(const string& line, char delimiter, int start) {
         tokens.push_back(token);
     }
     return tokens;
+}
+
+Command parseCommand(const string& inputs, string* error) {
+    auto report = [error](const string& message) {
+        if (error)
+            *error = message;
+    };
+    Command cmd;
+    if (inputs.find("begin") == 0) {
+        vector<string> str = split(inputs, ',', 5);
+        if (str.size() != 1)
+            report("Invalid input command: " + inputs);
+
+        cmd.type = CommandType::Begin;
+        cmd.id = stoi(str[0].substr(1));
+    }
+    else if (inputs.find("RB(") == 0 || inputs.find("WB(") == 0) {
+        // RB(T1, x1, x2, ...) or WB(T1, x1=10, x2=20, ...)
+        vector<string> str = split(inputs, ',', 2);
+        if (str.size() < 2) {
+            report("Invalid input command: " + inputs);
+            return cmd;
+        }
+
+        bool isWrite = inputs[0] == 'W';
+        for (size_t i = 1; i < str.size(); ++i) {
+            size_t eq = str[i].find('=');
+            if (isWrite != (eq != string::npos)) {
+                report("Invalid input command: " + inputs);
+                return cmd;
+            }
+            var_id var = stoi(str[i].substr(1, eq == string::npos ? string::npos : eq - 1));
+            cmd.batch.emplace_back(var, isWrite ? stoi(str[i].substr(eq + 1)) : 0);
+        }
+        cmd.type = isWrite ? CommandType::WriteBatch : CommandType::ReadBatch;
+        cmd.id = stoi(str[0].substr(1));
+    }
+    else if (inputs.find("R") != string::npos) {
+        vector<string> str = split(inputs, ',', 1);
+        if (str.size() != 2)
+            report("Invalid input command: " + inputs);
+
+        cmd.type = CommandType::Read;
+        cmd.id = stoi(str[0].substr(1));
+        cmd.var = stoi(str[1].substr(1));
+    }
+    else if (inputs.find("W") != string::npos) {
+        vector<string> str = split(inputs, ',', 1);
+        if (str.size() != 3)
+            report("Invalid input command: " + inputs);
+
+        cmd.type = CommandType::Write;
+        cmd.id = stoi(str[0].substr(1));
+        cmd.var = stoi(str[1].substr(1));
+        cmd.value = stoi(str[2]);
+    }
+    else if (inputs.find("end") == 0) {
+        vector<string> str = split(inputs, ',', 3);
+        if (str.size() != 1)
+            report("Invalid input command: " + inputs);
+
+        cmd.type = CommandType::End;
+        cmd.id = stoi(str[0].substr(1));
+    }
+    else if (inputs.find("fail") == 0) {
+        vector<string> str = split(inputs, ',', 4);
+        if (str.size() != 1)
+            report("Invalid input command: " + inputs);
+
+        cmd.type = CommandType::Fail;
+        cmd.id = stoi(str[0]);
+    }
+    else if (inputs.find("recover") == 0) {
+        vector<string> str = split(inputs, ',', 7);
+        if (str.size() != 1)
+            report("Invalid input command: " + inputs);
+
+        cmd.type = CommandType::Recover;
+        cmd.id = stoi(str[0]);
+    }
+    else if (inputs.find("replication") == 0) {
+        vector<string> str = split(inputs, ',', 11);
+        if (str.empty() || str.size() > 2)
+            report("Invalid input command: " + inputs);
+
+        const vector<string> policies = { "all", "quorum", "async" };
+        auto it = find(policies.begin(), policies.end(), str[0]);
+        if (it == policies.end()) {
+            report("Invalid replication policy: " + str[0]);
+            return cmd;
+        }
+        cmd.type = CommandType::Replication;
+        cmd.id = static_cast<int>(it - policies.begin());
+        cmd.value = str.size() > 1 ? stoi(str[1]) : 0;
+    }
+    else if (inputs.find("readAt") == 0) {
+        vector<string> str = split(inputs, ',', 6);
+        if (str.size() != 2)
+            report("Invalid input command: " + inputs);
+
+        cmd.type = CommandType::ReadAt;
+        cmd.var = stoi(str[0].substr(1));
+        cmd.time = stod(str[1]);
+    }
+    else if (inputs.find("admission") == 0) {
+        // admission(maxActive, maxBlocked, timeout[, maxQueued]), or bare admission for stats
+        if (inputs.find('(') == string::npos) {
+            cmd.type = CommandType::AdmissionStats;
+            return cmd;
+        }
+        vector<string> str = split(inputs, ',', 9);
+        if (str.size() < 3 || str.size() > 4) {
+            report("Invalid input command: " + inputs);
+            return cmd;
+        }
+        cmd.type = CommandType::Admission;
+        cmd.id = stoi(str[0]);
+        cmd.var = stoi(str[1]);
+        cmd.time = stod(str[2]);
+        cmd.value = str.size() > 3 ? stoi(str[3]) : -1;
+    }
+    else if (inputs.find("contention") == 0) {
+        // contention, or contention(k) for the k hottest variables
+        if (inputs.find('(') == string::npos) {
+            cmd.type = CommandType::Contention;
+            return cmd;
+        }
+        vector<string> str = split(inputs, ',', 10);
+        if (str.size() > 1) {
+            report("Invalid input command: " + inputs);
+            return cmd;
+        }
+        cmd.type = CommandType::Contention;
+        cmd.id = str.empty() ? 0 : stoi(str[0]);
+    }
+    else if (inputs.find("lag") == 0)
+        cmd.type = CommandType::Lag;
+    else if (inputs.find("dump") == 0) {
+        vector<string> str = split(inputs, ',', 4);
+        cmd.type = CommandType::Dump;
+        if (!str.empty())
+            cmd.time = stod(str[0]);
+    }
+    else if (inputs.find("queryState") == 0)
+        cmd.type = CommandType::QueryState;
+    return cmd;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-03-2024
- * Last Edited:   12-07-2024
+ * Last Edited:   10-19-2026
  * Description:   This file contains the implementation of functions for
  *                managing and operating on a serialization graph.
  *				  The graph is used to track transaction dependencies in a system
@@ -134,4 +134,219 @@ SerializationGraph::getEdges(tran_id tranID) const {
 	}
 
 	return { outEdges, inEdges };
+}
+
+/*
+ * Whether tranID lies on a cycle through committed transactions. Committed
+ * transactions never form a cycle among themselves (each one passed this
+ * check when it committed), so this answers what hasCycle() does, but only
+ * walks the part of the graph reachable from tranID.
+ */
+bool SerializationGraph::onCycle(
+	const tran_id tranID,
+	const unordered_map<tran_id, Status>& statusList
+) const {
+	if (!graph.count(tranID))
+		return false;
+
+	unordered_set<tran_id> visited;
+	stack<tran_id> next;
+	next.push(tranID);
+	while (!next.empty()) {
+		tran_id node = next.top();
+		next.pop();
+		for (const auto& [v, type] : graph.at(node)) {
+			if (v == tranID)
+				return true;
+			auto it = statusList.find(v);
+			if (it == statusList.end() || it->second != Status::commit)
+				continue;
+			if (visited.insert(v).second)
+				next.push(v);
+		}
+	}
+	return false;
+}
+
+SerializationGraph::BatchCheck::BatchCheck(
+	const SerializationGraph& g,
+	const vector<tran_id>& candidates,
+	const unordered_map<tran_id, Status>& statusList
+) : g(g), statusList(statusList), words((candidates.size() + 63) / 64),
+	paths(candidates.size(), vector<uint64_t>(words)), known(candidates.size()), ended(candidates.size()) {
+	for (size_t i = 0; i < candidates.size(); ++i)
+		slots.emplace(candidates[i], Slot{ candidateNode, i, done });
+}
+
+// every node met gets a slot, so following an edge costs one lookup
+SerializationGraph::BatchCheck::Slot& SerializationGraph::BatchCheck::slotOf(const tran_id v) {
+	auto it = slots.find(v);
+	if (it != slots.end())
+		return it->second;
+	auto sIt = statusList.find(v);
+	if (sIt == statusList.end() || sIt->second != Status::commit || !g.graph.count(v))
+		return slots.emplace(v, Slot{ otherNode, 0, done }).first->second;
+	reach.resize(reach.size() + words);
+	return slots.emplace(v, Slot{ committedNode, reach.size() / words - 1, fresh }).first->second;
+}
+
+/*
+ * Add to reach the candidates the committed node v leads to, depth first.
+ * Returns 1 when candidate i is among them (a cycle through committed
+ * transactions only), -1 when the committed transactions hold a cycle, 0
+ * otherwise. Rows left unfinished by an early return are reset.
+ */
+int SerializationGraph::BatchCheck::follow(const size_t i, const tran_id v) {
+	auto push = [&](Slot& s, tran_id u) {
+		const auto& edges = g.graph.at(u);
+		s.state = open;
+		frames.push_back({ &s, edges.begin(), edges.end() });
+	};
+	auto stop = [&](int result) {
+		for (const Frame& f : frames) {
+			f.slot->state = fresh;
+			fill(reach.begin() + f.slot->index * words, reach.begin() + (f.slot->index + 1) * words, 0);
+		}
+		frames.clear();
+		return result;
+	};
+
+	push(slotOf(v), v);
+	while (!frames.empty()) {
+		Frame& f = frames.back();
+		size_t row = f.slot->index * words;
+		if (f.next == f.end) {
+			f.slot->state = done;
+			frames.pop_back();
+			if (!frames.empty()) {
+				size_t parent = frames.back().slot->index * words;
+				for (size_t w = 0; w < words; ++w)
+					reach[parent + w] |= reach[row + w];
+			}
+			continue;
+		}
+		tran_id u = (f.next++)->first;
+		Slot& s = slotOf(u);
+		if (s.kind == candidateNode) {
+			if (s.index == i)
+				return stop(1);
+			reach[row + s.index / 64] |= 1ull << (s.index % 64);
+		}
+		else if (s.kind == committedNode) {
+			if (s.state == open)
+				return stop(-1);
+			if (s.state == fresh)
+				push(s, u);
+			else if (reach[s.index * words + i / 64] >> (i % 64) & 1)
+				return stop(1);
+			else {
+				for (size_t w = 0; w < words; ++w)
+					reach[row + w] |= reach[s.index * words + w];
+			}
+		}
+	}
+	return 0;
+}
+
+/*
+ * Whether tranID is on a cycle through committed transactions, answered from
+ * the shared traversal. Call in validation order, with committed() for each
+ * candidate that commits: paths through candidates that did are real paths.
+ */
+SerializationGraph::Verdict SerializationGraph::BatchCheck::verdict(const tran_id tranID) {
+	auto it = slots.find(tranID);
+	auto gIt = g.graph.find(tranID);
+	if (it == slots.end() || it->second.kind != candidateNode || gIt == g.graph.end())
+		return undecided;
+	size_t i = it->second.index;
+
+	// candidates tranID leads to through the committed transactions
+	vector<uint64_t>& row = paths[i];
+	for (const auto& [v, type] : gIt->second) {
+		Slot& s = slotOf(v);
+		if (s.kind == candidateNode) {
+			if (s.index == i)
+				return cycle;
+			row[s.index / 64] |= 1ull << (s.index % 64);
+			continue;
+		}
+		if (s.kind != committedNode)
+			continue;
+		if (s.state == fresh) {
+			int found = follow(i, v);
+			if (found != 0)
+				return found > 0 ? cycle : undecided;
+		}
+		if (reach[s.index * words + i / 64] >> (i % 64) & 1)
+			return cycle;
+		for (size_t w = 0; w < words; ++w)
+			row[w] |= reach[s.index * words + w];
+	}
+	known[i] = true;
+
+	// back to tranID through the candidates committed since the batch began
+	vector<bool> seen(paths.size());
+	vector<size_t> next = { i };
+	while (!next.empty()) {
+		size_t u = next.back();
+		next.pop_back();
+		for (size_t w = 0; w < words; ++w) {
+			for (uint64_t bits = paths[u][w]; bits; bits &= bits - 1) {
+				size_t c = w * 64 + __builtin_ctzll(bits);
+				if (c == i)
+					return cycle;
+				if (!ended[c] || seen[c])
+					continue;
+				if (!known[c])
+					return undecided;
+				seen[c] = true;
+				next.push_back(c);
+			}
+		}
+	}
+	return noCycle;
+}
+
+void SerializationGraph::BatchCheck::committed(const tran_id tranID) {
+	auto it = slots.find(tranID);
+	if (it != slots.end() && it->second.kind == candidateNode)
+		ended[it->second.index] = true;
+}
+
+/*
+ * Summarize the graph between a set of portal transactions: returns (p, q) for
+ * every pair of portals where q is reachable from p along a path hasCycle()
+ * would follow (every node after p is committed or tranID). Used to exchange
+ * dependencies between shards without shipping whole graphs.
+ */
+vector<pair<tran_id, tran_id>> SerializationGraph::getPortalPaths(
+	const tran_id tranID,
+	const unordered_set<tran_id>& portals,
+	const unordered_map<tran_id, Status>& statusList
+) const {
+	vector<pair<tran_id, tran_id>> paths;
+
+	for (tran_id p : portals) {
+		if (!graph.count(p))
+			continue;
+		unordered_set<tran_id> visited;
+		stack<tran_id> next;
+		next.push(p);
+		while (!next.empty()) {
+			tran_id node = next.top();
+			next.pop();
+			for (const auto& [v, type] : graph.at(node)) {
+				auto it = statusList.find(v);
+				if (v != tranID && (it == statusList.end() || it->second != Status::commit))
+					continue;
+				if (visited.count(v))
+					continue;
+				visited.insert(v);
+				if (portals.count(v))
+					paths.emplace_back(p, v);
+				next.push(v);
+			}
+		}
+	}
+	return paths;
 }
\ No newline at end of file
@@ -1,13 +1,38 @@
 /*****************************************************************************
  * Author:        Xinyu Li
  * Created:       12-02-2024
- * Last Edited:   12-07-2024
+ * Last Edited:   10-19-2026
  * Description:   The main entry point of the project.
  *                It supports input from either a .txt file or command line.
  *                The program reads the input instructions and invokes the 
  *                TransactionManager functions to parse and execute them iteratively.
+ *                It is a thin client of the repcrec library: results come
+ *                back through a TextPrinter, which prints them to stdout.
+ *                With a shard number, the instructions are executed by a
+ *                ShardCoordinator over that many TransactionManager shards.
+ *                With "--sim", the file is replayed in the discrete-event
+ *                Simulator and only the simulation report is printed.
+ *                Binary traces (see Trace.h) are recognized by their magic
+ *                and replayed without text parsing; "--convert <out>"
+ *                writes the binary form of a text trace.
+ *                Trace files end transactions in batches of 64, validated
+ *                together (see TransactionManager::setCommitBatch).
+ *                "--export <output> [text|binary]" replays the file, then
+ *                exports a snapshot of every site (see SnapshotExport) and
+ *                prints the export throughput.
+ *                "--actors" replays the file with every site on a thread
+ *                of its own (see SiteActors); the output is the same.
+ *                At exit, the variables with the most contention are
+ *                printed to stderr, so the transcript on stdout is unchanged.
  * 
- * Inputs:        Input through a .txt file under "/test" or via command line
+ * Inputs:        Input through a .txt or binary trace file under "/test" or
+ *                via command line
+ *                Optional second argument: number of shards,
+ *                "--sim [mtbf [mttr]]" for simulation mode, or
+ *                "--convert <output>" to write its binary trace under "/test",
+ *                "--export <output> [text|binary]" to write a snapshot
+ *                under "/test" after the replay, or "--actors" to run the
+ *                sites on their own threads
  * 
  * Outputs:       0 (successful execution)
  * 
@@ -19,37 +44,152 @@
 #include "common.h"
 #include "TransactionManager.h"
 #include "DataManager.h"
+#include "ShardCoordinator.h"
+#include "Simulator.h"
+#include "TextPrinter.h"
+#include "Trace.h"
 
 TransactionManager *manager;
+ShardCoordinator *coordinator;
+
+static void handle(const string& line) {
+    if (coordinator)
+        coordinator->inputHandle(line);
+    else
+        manager->inputHandle(line);
+}
+
+static void handle(const Command& cmd) {
+    if (coordinator)
+        coordinator->execute(cmd);
+    else
+        manager->execute(cmd);
+}
+
+// --convert <output>: write the binary form of a text trace
+static int convert(const string& path, const string& output) {
+    ifstream textFile(path);
+    if (!textFile.is_open()) {
+        cout << "Failed to open test file" << endl;
+        return 1;
+    }
+    ofstream binaryFile(output, ios::binary);
+    if (!binaryFile.is_open()) {
+        cout << "Failed to open output file" << endl;
+        return 1;
+    }
+    vector<string> errors;
+    size_t count = TraceWriter::convert(textFile, binaryFile, &errors);
+    for (const string& error : errors)
+        cout << error << endl;
+    cout << count << " commands written to " << output << endl;
+    return 0;
+}
+
+// --sim [mtbf [mttr]]: replay the file in the discrete-event simulator
+static int simulate(const string& path, int argc, char **argv) {
+    Simulator::Config config;
+    if (argc > 3)
+        config.mtbf = stod(argv[3]);
+    if (argc > 4)
+        config.mttr = stod(argv[4]);
+
+    ifstream testFile(path, ios::binary);
+    if (!testFile.is_open()) {
+        cout << "Failed to open test file" << endl;
+        return 1;
+    }
+    Simulator sim(config);      // engine results are not shown in simulation
+    sim.load(testFile);
+    sim.run();
+    sim.report(cout);
+    return 0;
+}
+
+// --export <output> [text|binary]: snapshot of every site after the replay
+static int exportSites(const string& path, const string& format) {
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) {
+        cout << "Failed to open output file" << endl;
+        return 1;
+    }
+    unique_ptr<SnapshotExport> job = manager->exportSnapshot(out, format == "binary" ? ExportFormat::binary : ExportFormat::text);
+    SnapshotExport::Stats stats = job->wait();
+    cout << stats.values << " values from " << stats.sites << " sites written to " << path
+        << " (" << stats.bytes << " bytes, " << stats.threads << " threads, " << stats.seconds * 1000 << " ms, "
+        << (stats.seconds > 0 ? stats.values / stats.seconds : 0.0) << " values/s)" << endl;
+    return 0;
+}
 
 int main(int argc, char **argv) {
-    manager = new TransactionManager();
+    if (argc > 2 && string(argv[2]) == "--sim")
+        return simulate(string("./test/") + argv[1], argc, argv);
+    if (argc > 3 && string(argv[2]) == "--convert")
+        return convert(string("./test/") + argv[1], string("./test/") + argv[3]);
+    bool exporting = argc > 3 && string(argv[2]) == "--export";
+    bool siteActors = argc > 2 && string(argv[2]) == "--actors";
+
+    TextPrinter printer(cout);
+    if (argc > 2 && !exporting && !siteActors)
+        coordinator = new ShardCoordinator(stoi(argv[2]), &printer);
+    else {
+        manager = new TransactionManager();
+        manager->setSink(&printer);
+        manager->setSiteActors(siteActors);
+    }
 
 
     string line;
     if (argc > 1) {
         string base = "./test/";
         string path = base + argv[1];
-        ifstream testFile(path);
+        ifstream testFile(path, ios::binary);
         if (!testFile.is_open()) {
             cout << "Failed to open test file" << endl;
             return 1;
         }
-        while (getline(testFile, line)) {
-            manager->inputHandle(line);
-            globalTime += 0.1;
+        if (manager)
+            manager->setCommitBatch(64);
+        if (TraceReader::isBinary(testFile)) {
+            TraceReader reader(testFile);
+            Command cmd;
+            double time;
+            while (reader.next(cmd, time)) {
+                globalTime = time;
+                handle(cmd);
+            }
+        }
+        else {
+            while (getline(testFile, line)) {
+                handle(line);
+                globalTime += 0.1;
+            }
         }
         testFile.close();
+        if (manager)
+            manager->flush();
     }
     else {
         cout << "Input Command: " << endl;
         while (getline(cin, line)) {
             if (line.empty())
                 break;
-            manager->inputHandle(line);
+            handle(line);
             globalTime += 0.1;
         }
     }
 
+    if (exporting && exportSites(string("./test/") + argv[3], argc > 4 ? argv[4] : "text") != 0)
+        return 1;
+
+    vector<HotVariable> hot = coordinator ? coordinator->hotVariables(ContentionProfiler::defaultTop)
+        : manager->hotVariables(ContentionProfiler::defaultTop);
+    if (!hot.empty()) {
+        TextPrinter report(cerr);
+        cerr << "=== contention" << endl;
+        report.onContention(hot);
+    }
+
+    delete coordinator;
     return 0;
-}
\ No newline at end of file
+}